@@ -0,0 +1,111 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#include "Aggregation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+struct AggregateOperationName {
+	const char* mName;
+	AggregateOperation mOperation;
+};
+
+const AggregateOperationName AGGREGATE_OPERATIONS[] = {{"sum", AggregateOperation::SUM},
+                                                       {"mean", AggregateOperation::MEAN},
+                                                       {"min", AggregateOperation::MIN},
+                                                       {"max", AggregateOperation::MAX},
+                                                       {"count", AggregateOperation::COUNT}};
+
+GroupKey getGroupKey(const Column& column, size_t row) {
+	if (!column.isValid(row))
+		return std::monostate{};
+	switch (column.mType) {
+		case Column::Type::BOOL:
+			return column.getBool(row);
+		case Column::Type::FLOAT:
+			if (std::isnan(column.mFloats[row]))
+				return std::monostate{};
+			return column.mFloats[row];
+		default:
+			return std::string(column.getString(row));
+	}
+}
+
+} // namespace
+
+bool getAggregateOperation(const std::string& name, AggregateOperation& operation) {
+	const auto it = std::find_if(std::begin(AGGREGATE_OPERATIONS), std::end(AGGREGATE_OPERATIONS),
+	                             [&name](const AggregateOperationName& o) { return name == o.mName; });
+	if (it == std::end(AGGREGATE_OPERATIONS))
+		return false;
+	operation = it->mOperation;
+	return true;
+}
+
+void Aggregate::add(double value) {
+	mCount++;
+	mSum += value;
+	mMin = std::min(mMin, value);
+	mMax = std::max(mMax, value);
+}
+
+double Aggregate::get(AggregateOperation operation) const {
+	switch (operation) {
+		case AggregateOperation::SUM:
+			return mSum;
+		case AggregateOperation::COUNT:
+			return static_cast<double>(mCount);
+		default:
+			break;
+	}
+
+	if (mCount == 0)
+		return std::nan("");
+	switch (operation) {
+		case AggregateOperation::MEAN:
+			return mSum / static_cast<double>(mCount);
+		case AggregateOperation::MIN:
+			return mMin;
+		default:
+			return mMax;
+	}
+}
+
+std::map<GroupKey, Aggregate> aggregateColumn(const Column& values, const Column* groupColumn) {
+	std::map<GroupKey, Aggregate> groups;
+	Aggregate* currentGroup = nullptr;
+	for (size_t r = 0; r < values.mLength; r++) {
+		if (groupColumn != nullptr)
+			currentGroup = &groups[getGroupKey(*groupColumn, r)];
+		else if (currentGroup == nullptr)
+			currentGroup = &groups[std::monostate{}];
+
+		if (!values.isValid(r))
+			continue;
+		if (values.mType == Column::Type::FLOAT)
+			currentGroup->add(values.mFloats[r]);
+		else if (values.mType == Column::Type::BOOL)
+			currentGroup->add(values.getBool(r) ? 1.0 : 0.0);
+	}
+	return groups;
+}
@@ -0,0 +1,51 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#pragma once
+
+#include "ColumnTable.h"
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <string>
+#include <variant>
+
+enum class AggregateOperation { SUM, MEAN, MIN, MAX, COUNT };
+
+bool getAggregateOperation(const std::string& name, AggregateOperation& operation);
+
+struct Aggregate {
+	size_t mCount = 0;
+	double mSum = 0.0;
+	double mMin = std::numeric_limits<double>::infinity();
+	double mMax = -std::numeric_limits<double>::infinity();
+
+	void add(double value);
+	double get(AggregateOperation operation) const; // NaN for the mean, min and max of an empty group
+};
+
+// the value of the group column, std::monostate for null and NaN (which cannot be ordered)
+using GroupKey = std::variant<std::monostate, bool, double, std::string>;
+
+/**
+ * Aggregates the valid values of a float or bool column (bools count as 0 and 1) per value of the group column. All
+ * rows form one group with the key std::monostate if there is no group column.
+ */
+std::map<GroupKey, Aggregate> aggregateColumn(const Column& values, const Column* groupColumn);
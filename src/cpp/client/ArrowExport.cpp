@@ -0,0 +1,352 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#include "ArrowExport.h"
+
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct SchemaNode {
+	SchemaNode(std::string format, std::string name, int64_t flags = ARROW_FLAG_NULLABLE)
+	    : mFormat(std::move(format)), mName(std::move(name)), mFlags(flags) {}
+
+	std::string mFormat;
+	std::string mName;
+	std::string mMetadata;
+	int64_t mFlags = ARROW_FLAG_NULLABLE;
+	std::vector<SchemaNode> mChildren;
+};
+
+struct ArrayNode {
+	ArrayNode(int64_t length, int64_t nullCount, std::vector<const void*> buffers)
+	    : mLength(length), mNullCount(nullCount), mBuffers(std::move(buffers)) {}
+
+	int64_t mLength = 0;
+	int64_t mNullCount = 0;
+	std::vector<const void*> mBuffers;
+	std::vector<ArrayNode> mChildren;
+};
+
+struct SchemaPrivateData {
+	std::string mFormat;
+	std::string mName;
+	std::string mMetadata;
+	std::vector<ArrowSchema> mChildren;
+	std::vector<ArrowSchema*> mChildPointers;
+};
+
+// consumers may move children out of their parent, therefore every array keeps the batch alive on its own
+struct ArrayPrivateData {
+	std::shared_ptr<const GeneratedBatch> mBatch;
+	std::vector<const void*> mBuffers;
+	std::vector<ArrowArray> mChildren;
+	std::vector<ArrowArray*> mChildPointers;
+};
+
+void releaseSchema(ArrowSchema* schema) {
+	auto* data = static_cast<SchemaPrivateData*>(schema->private_data);
+	for (ArrowSchema& child : data->mChildren) {
+		if (child.release != nullptr)
+			child.release(&child);
+	}
+	delete data;
+	schema->release = nullptr;
+}
+
+void releaseArray(ArrowArray* array) {
+	auto* data = static_cast<ArrayPrivateData*>(array->private_data);
+	for (ArrowArray& child : data->mChildren) {
+		if (child.release != nullptr)
+			child.release(&child);
+	}
+	delete data;
+	array->release = nullptr;
+}
+
+void exportSchemaNode(SchemaNode& node, ArrowSchema* schema) {
+	auto* data = new SchemaPrivateData{std::move(node.mFormat), std::move(node.mName), std::move(node.mMetadata), {},
+	                                   {}};
+	data->mChildren.resize(node.mChildren.size());
+	for (size_t i = 0; i < node.mChildren.size(); i++) {
+		exportSchemaNode(node.mChildren[i], &data->mChildren[i]);
+		data->mChildPointers.push_back(&data->mChildren[i]);
+	}
+
+	schema->format = data->mFormat.c_str();
+	schema->name = data->mName.c_str();
+	schema->metadata = data->mMetadata.empty() ? nullptr : data->mMetadata.data();
+	schema->flags = node.mFlags;
+	schema->n_children = static_cast<int64_t>(data->mChildPointers.size());
+	schema->children = data->mChildPointers.data();
+	schema->dictionary = nullptr;
+	schema->release = &releaseSchema;
+	schema->private_data = data;
+}
+
+void exportArrayNode(ArrayNode& node, const std::shared_ptr<const GeneratedBatch>& batch, ArrowArray* array) {
+	auto* data = new ArrayPrivateData{batch, std::move(node.mBuffers), {}, {}};
+	data->mChildren.resize(node.mChildren.size());
+	for (size_t i = 0; i < node.mChildren.size(); i++) {
+		exportArrayNode(node.mChildren[i], batch, &data->mChildren[i]);
+		data->mChildPointers.push_back(&data->mChildren[i]);
+	}
+
+	array->length = node.mLength;
+	array->null_count = node.mNullCount;
+	array->offset = 0;
+	array->n_buffers = static_cast<int64_t>(data->mBuffers.size());
+	array->n_children = static_cast<int64_t>(data->mChildPointers.size());
+	array->buffers = data->mBuffers.data();
+	array->children = data->mChildPointers.data();
+	array->dictionary = nullptr;
+	array->release = &releaseArray;
+	array->private_data = data;
+}
+
+// key/value metadata in the binary format of the C data interface: int32 counts and lengths in native byte order
+std::string createMetadata(const std::vector<std::pair<std::string, std::string>>& entries) {
+	std::string metadata;
+	auto appendInt32 = [&metadata](size_t value) {
+		const auto v = static_cast<int32_t>(value);
+		metadata.append(reinterpret_cast<const char*>(&v), sizeof(v));
+	};
+	appendInt32(entries.size());
+	for (const auto& [key, value] : entries) {
+		appendInt32(key.size());
+		metadata += key;
+		appendInt32(value.size());
+		metadata += value;
+	}
+	return metadata;
+}
+
+const char* getFormat(Column::Type type) {
+	switch (type) {
+		case Column::Type::BOOL:
+			return "b";
+		case Column::Type::FLOAT:
+			return "g";
+		default:
+			return "U"; // large UTF-8 string, 64 bit offsets
+	}
+}
+
+SchemaNode getTableSchema(const std::string& name, const ColumnTable& table) {
+	SchemaNode node("+s", name);
+	for (const Column& column : table.getColumns())
+		node.mChildren.emplace_back(getFormat(column.mType), column.mName);
+	return node;
+}
+
+ArrayNode getTableArray(const ColumnTable& table) {
+	ArrayNode node(static_cast<int64_t>(table.getRowCount()), 0, {nullptr});
+	for (const Column& column : table.getColumns()) {
+		ArrayNode columnNode(static_cast<int64_t>(column.mLength), static_cast<int64_t>(column.mNullCount),
+		                     {column.mNullCount > 0 ? column.mValidity.data() : nullptr});
+		switch (column.mType) {
+			case Column::Type::BOOL:
+				columnNode.mBuffers.push_back(column.mBools.data());
+				break;
+			case Column::Type::FLOAT:
+				columnNode.mBuffers.push_back(column.mFloats.data());
+				break;
+			default:
+				columnNode.mBuffers.push_back(column.mStringOffsets.data());
+				columnNode.mBuffers.push_back(column.mStrings.data());
+				break;
+		}
+		node.mChildren.push_back(std::move(columnNode));
+	}
+	return node;
+}
+
+// large list (64 bit offsets) of the given child, the uint64 offsets of the batch have the same memory layout
+ArrayNode getListArray(const std::vector<uint64_t>& offsets, ArrayNode&& child) {
+	ArrayNode node(static_cast<int64_t>(offsets.size() - 1), 0, {nullptr, offsets.data()});
+	node.mChildren.push_back(std::move(child));
+	return node;
+}
+
+SchemaNode createSchema(const GeneratedBatch& batch) {
+	// the vertices of a model are a GeoArrow multipoint with interleaved xyz coordinates
+	SchemaNode vertices("+L", "vertices");
+	vertices.mMetadata = createMetadata({{"ARROW:extension:name", "geoarrow.multipoint"},
+	                                     {"ARROW:extension:metadata", "{}"}});
+	SchemaNode& points = vertices.mChildren.emplace_back("+w:3", "points", 0);
+	points.mChildren.emplace_back("g", "xyz", 0);
+
+	SchemaNode indices("+L", "indices");
+	indices.mChildren.emplace_back("I", "item", 0);
+	SchemaNode faces("+L", "faces");
+	faces.mChildren.emplace_back("I", "item", 0);
+
+	SchemaNode root("+s", "", 0);
+	root.mChildren.push_back(std::move(vertices));
+	root.mChildren.push_back(std::move(indices));
+	root.mChildren.push_back(std::move(faces));
+	if (!batch.getReports().getColumns().empty())
+		root.mChildren.push_back(getTableSchema("report", batch.getReports()));
+	if (!batch.getAttributes().getColumns().empty())
+		root.mChildren.push_back(getTableSchema("attributes", batch.getAttributes()));
+	return root;
+}
+
+ArrayNode createArray(const GeneratedBatch& batch) {
+	const auto vertexCount = static_cast<int64_t>(batch.getVertices().size() / 3);
+	ArrayNode points(vertexCount, 0, {nullptr});
+	points.mChildren.emplace_back(3 * vertexCount, 0, std::vector<const void*>{nullptr, batch.getVertices().data()});
+
+	ArrayNode indices(static_cast<int64_t>(batch.getIndices().size()), 0, {nullptr, batch.getIndices().data()});
+	ArrayNode faces(static_cast<int64_t>(batch.getFaces().size()), 0, {nullptr, batch.getFaces().data()});
+
+	ArrayNode root(static_cast<int64_t>(batch.getModelCount()), 0, {nullptr});
+	root.mChildren.push_back(getListArray(batch.getVertexOffsets(), std::move(points)));
+	root.mChildren.push_back(getListArray(batch.getIndexOffsets(), std::move(indices)));
+	root.mChildren.push_back(getListArray(batch.getFaceOffsets(), std::move(faces)));
+	if (!batch.getReports().getColumns().empty())
+		root.mChildren.push_back(getTableArray(batch.getReports()));
+	if (!batch.getAttributes().getColumns().empty())
+		root.mChildren.push_back(getTableArray(batch.getAttributes()));
+	return root;
+}
+
+struct StreamPrivateData {
+	GeneratedBatchPtr mBatch;
+	bool mDone = false;
+};
+
+int getStreamSchema(ArrowArrayStream* stream, ArrowSchema* schema) {
+	try {
+		arrow_export::exportSchema(*static_cast<StreamPrivateData*>(stream->private_data)->mBatch, schema);
+		return 0;
+	}
+	catch (const std::bad_alloc&) {
+		return ENOMEM;
+	}
+	catch (...) {
+		return EIO;
+	}
+}
+
+// the stream consists of one record batch
+int getStreamNext(ArrowArrayStream* stream, ArrowArray* array) {
+	auto* data = static_cast<StreamPrivateData*>(stream->private_data);
+	if (data->mDone) {
+		array->release = nullptr; // end of stream
+		return 0;
+	}
+	try {
+		arrow_export::exportArray(data->mBatch, array);
+		data->mDone = true;
+		return 0;
+	}
+	catch (const std::bad_alloc&) {
+		return ENOMEM;
+	}
+	catch (...) {
+		return EIO;
+	}
+}
+
+const char* getStreamLastError(ArrowArrayStream* /*stream*/) {
+	return nullptr;
+}
+
+void releaseStream(ArrowArrayStream* stream) {
+	delete static_cast<StreamPrivateData*>(stream->private_data);
+	stream->release = nullptr;
+}
+
+constexpr const char* SCHEMA_CAPSULE_NAME = "arrow_schema";
+constexpr const char* ARRAY_CAPSULE_NAME = "arrow_array";
+constexpr const char* STREAM_CAPSULE_NAME = "arrow_array_stream";
+
+template <typename T>
+void releaseCapsule(PyObject* capsule, const char* name) {
+	auto* object = static_cast<T*>(PyCapsule_GetPointer(capsule, name));
+	if (object == nullptr) {
+		PyErr_Clear();
+		return;
+	}
+	// the consumer sets release to nullptr if it took over the object
+	if (object->release != nullptr)
+		object->release(object);
+	delete object;
+}
+
+void releaseSchemaCapsule(PyObject* capsule) {
+	releaseCapsule<ArrowSchema>(capsule, SCHEMA_CAPSULE_NAME);
+}
+
+void releaseArrayCapsule(PyObject* capsule) {
+	releaseCapsule<ArrowArray>(capsule, ARRAY_CAPSULE_NAME);
+}
+
+void releaseStreamCapsule(PyObject* capsule) {
+	releaseCapsule<ArrowArrayStream>(capsule, STREAM_CAPSULE_NAME);
+}
+
+} // namespace
+
+namespace arrow_export {
+
+void exportSchema(const GeneratedBatch& batch, ArrowSchema* schema) {
+	SchemaNode root = createSchema(batch);
+	exportSchemaNode(root, schema);
+}
+
+void exportArray(const GeneratedBatchPtr& batch, ArrowArray* array) {
+	ArrayNode root = createArray(*batch);
+	exportArrayNode(root, batch, array);
+}
+
+void exportStream(const GeneratedBatchPtr& batch, ArrowArrayStream* stream) {
+	stream->get_schema = &getStreamSchema;
+	stream->get_next = &getStreamNext;
+	stream->get_last_error = &getStreamLastError;
+	stream->release = &releaseStream;
+	stream->private_data = new StreamPrivateData{batch};
+}
+
+pybind11::tuple toArrowArrayCapsules(const GeneratedBatchPtr& batch, const pybind11::object& /*requestedSchema*/) {
+	auto* schema = new ArrowSchema;
+	exportSchema(*batch, schema);
+	pybind11::capsule schemaCapsule(schema, SCHEMA_CAPSULE_NAME, &releaseSchemaCapsule);
+
+	auto* array = new ArrowArray;
+	exportArray(batch, array);
+	pybind11::capsule arrayCapsule(array, ARRAY_CAPSULE_NAME, &releaseArrayCapsule);
+
+	return pybind11::make_tuple(schemaCapsule, arrayCapsule);
+}
+
+pybind11::capsule toArrowStreamCapsule(const GeneratedBatchPtr& batch, const pybind11::object& /*requestedSchema*/) {
+	auto* stream = new ArrowArrayStream;
+	exportStream(batch, stream);
+	return pybind11::capsule(stream, STREAM_CAPSULE_NAME, &releaseStreamCapsule);
+}
+
+} // namespace arrow_export
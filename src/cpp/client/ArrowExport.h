@@ -0,0 +1,92 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#pragma once
+
+#include "GeneratedBatch.h"
+
+#include "pybind11/pybind11.h"
+
+#include <cstdint>
+
+// the structs of the Arrow C data and C stream interfaces, see https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+	const char* format;
+	const char* name;
+	const char* metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema** children;
+	struct ArrowSchema* dictionary;
+	void (*release)(struct ArrowSchema*);
+	void* private_data;
+};
+
+struct ArrowArray {
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void** buffers;
+	struct ArrowArray** children;
+	struct ArrowArray* dictionary;
+	void (*release)(struct ArrowArray*);
+	void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream {
+	int (*get_schema)(struct ArrowArrayStream*, struct ArrowSchema* out);
+	int (*get_next)(struct ArrowArrayStream*, struct ArrowArray* out);
+	const char* (*get_last_error)(struct ArrowArrayStream*);
+	void (*release)(struct ArrowArrayStream*);
+	void* private_data;
+};
+
+#endif // ARROW_C_STREAM_INTERFACE
+
+/**
+ * Exports a GeneratedBatch as Arrow record batch with one row per model. The geometry columns are GeoArrow-style large
+ * lists, the reports and rule attributes are struct columns with one child per key. The arrays share the buffers of
+ * the batch and keep it alive until they are released.
+ */
+namespace arrow_export {
+
+void exportSchema(const GeneratedBatch& batch, ArrowSchema* schema);
+void exportArray(const GeneratedBatchPtr& batch, ArrowArray* array);
+void exportStream(const GeneratedBatchPtr& batch, ArrowArrayStream* stream);
+
+// the Arrow PyCapsule interface, see https://arrow.apache.org/docs/format/CDataInterface/PyCapsuleInterface.html
+// the requested schema is ignored, which the interface allows
+pybind11::tuple toArrowArrayCapsules(const GeneratedBatchPtr& batch, const pybind11::object& requestedSchema);
+pybind11::capsule toArrowStreamCapsule(const GeneratedBatchPtr& batch, const pybind11::object& requestedSchema);
+
+} // namespace arrow_export
@@ -0,0 +1,60 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+#include "AttributeKeyTable.h"
+#include "utils.h"
+
+AttributeKeyTable::AttributeKeyTable(const RuleFileInfoUPtr& ruleFileInfo) {
+	const std::unordered_set<std::wstring> hiddenAttrs = pcu::getHiddenAttributes(ruleFileInfo);
+	for (size_t ai = 0, numAttrs = ruleFileInfo->getNumAttributes(); ai < numAttrs; ai++) {
+		const wchar_t* name = ruleFileInfo->getAttribute(ai)->getName();
+		if (findOwn(name) == nullptr)
+			add(name, hiddenAttrs.count(name) > 0);
+	}
+}
+
+AttributeKeyTable::AttributeKeyTable(AttributeKeyTableConstPtr parent) : mParent(std::move(parent)) {}
+
+const AttributeKey* AttributeKeyTable::find(std::wstring_view rawKey) const {
+	if (const AttributeKey* key = findOwn(rawKey))
+		return key;
+	return mParent ? mParent->find(rawKey) : nullptr;
+}
+
+const AttributeKey* AttributeKeyTable::intern(std::wstring_view rawKey) {
+	// the rule package keys first, the parent tables are not changed anymore
+	if (mParent) {
+		if (const AttributeKey* key = mParent->find(rawKey))
+			return key;
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	const AttributeKey* key = findOwn(rawKey);
+	return (key != nullptr) ? key : &add(rawKey, false);
+}
+
+const AttributeKey* AttributeKeyTable::findOwn(std::wstring_view rawKey) const {
+	const auto it = mKeys.find(rawKey);
+	return (it != mKeys.end()) ? &it->second : nullptr;
+}
+
+const AttributeKey& AttributeKeyTable::add(std::wstring_view rawKey, bool hidden) {
+	const std::wstring& storedKey = mRawKeys.emplace_back(rawKey);
+	AttributeKey key{pcu::removeDefaultStyleName(storedKey.c_str()), hidden};
+	return mKeys.emplace(storedKey, std::move(key)).first->second;
+}
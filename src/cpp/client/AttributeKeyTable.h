@@ -0,0 +1,69 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+#pragma once
+
+#include "types.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * An attribute key as returned to Python (without the default style prefix) and whether the attribute is hidden.
+ */
+struct AttributeKey {
+	std::wstring mName;
+	bool mHidden = false;
+};
+
+class AttributeKeyTable;
+using AttributeKeyTablePtr = std::shared_ptr<AttributeKeyTable>;
+using AttributeKeyTableConstPtr = std::shared_ptr<const AttributeKeyTable>;
+
+/**
+ * Interned attribute keys, looked up by the key reported by PRT. The table of a rule package is built once from its
+ * rule file info. Each callbacks object adds a table on top of it for keys the rule package does not declare. The
+ * generated attributes only point to their keys. PRT calls the callbacks from several threads, intern() is therefore
+ * guarded by a mutex. The parent tables are not changed anymore and are read without locking.
+ */
+class AttributeKeyTable {
+public:
+	explicit AttributeKeyTable(const RuleFileInfoUPtr& ruleFileInfo);
+	explicit AttributeKeyTable(AttributeKeyTableConstPtr parent);
+	AttributeKeyTable(const AttributeKeyTable&) = delete;
+	AttributeKeyTable& operator=(const AttributeKeyTable&) = delete;
+
+	// must not run concurrently with intern() on the same table
+	const AttributeKey* find(std::wstring_view rawKey) const;
+
+	// like find(), but adds unknown keys to this table, thread-safe
+	const AttributeKey* intern(std::wstring_view rawKey);
+
+private:
+	const AttributeKey* findOwn(std::wstring_view rawKey) const;
+	const AttributeKey& add(std::wstring_view rawKey, bool hidden);
+
+	AttributeKeyTableConstPtr mParent;
+	std::mutex mMutex; // guards mRawKeys and mKeys in intern()
+	std::deque<std::wstring> mRawKeys; // owns the strings the map keys point to
+	std::unordered_map<std::wstring_view, AttributeKey> mKeys;
+};
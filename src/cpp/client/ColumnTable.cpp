@@ -0,0 +1,139 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#include "ColumnTable.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <variant>
+
+namespace {
+
+void setBit(std::vector<uint8_t>& bits, size_t index, bool value) {
+	const auto mask = static_cast<uint8_t>(1u << (index % 8));
+	if (value)
+		bits[index / 8] |= mask;
+	else
+		bits[index / 8] &= static_cast<uint8_t>(~mask);
+}
+
+bool getBit(const std::vector<uint8_t>& bits, size_t index) {
+	return (bits[index / 8] & (1u << (index % 8))) != 0;
+}
+
+void appendNull(Column& column) {
+	if (column.mLength % 8 == 0) {
+		column.mValidity.push_back(0);
+		if (column.mType == Column::Type::BOOL)
+			column.mBools.push_back(0);
+	}
+	if (column.mType == Column::Type::FLOAT)
+		column.mFloats.push_back(0.0);
+	else if (column.mType == Column::Type::STRING)
+		column.mStringOffsets.push_back(column.mStringOffsets.back());
+	column.mLength++;
+	column.mNullCount++;
+}
+
+} // namespace
+
+bool Column::isValid(size_t row) const {
+	return getBit(mValidity, row);
+}
+
+bool Column::getBool(size_t row) const {
+	return getBit(mBools, row);
+}
+
+std::string_view Column::getString(size_t row) const {
+	const auto first = static_cast<size_t>(mStringOffsets[row]);
+	const auto last = static_cast<size_t>(mStringOffsets[row + 1]);
+	return std::string_view(mStrings).substr(first, last - first);
+}
+
+size_t ColumnTable::getRowCount() const {
+	return mRowCount;
+}
+
+const std::vector<Column>& ColumnTable::getColumns() const {
+	return mColumns;
+}
+
+const Column* ColumnTable::findColumn(std::string_view name) const {
+	const auto it = std::find_if(mColumns.begin(), mColumns.end(),
+	                             [name](const Column& column) { return column.mName == name; });
+	return (it != mColumns.end()) ? &*it : nullptr;
+}
+
+void ColumnTable::addRow() {
+	for (Column& column : mColumns)
+		appendNull(column);
+	mRowCount++;
+}
+
+void ColumnTable::setValue(const std::wstring& key, const ReportValue& value) {
+	std::visit([this, &key](const auto& v) { setScalar(key, v); }, value);
+}
+
+void ColumnTable::setValue(const std::wstring& key, const AttributeValue& value) {
+	std::visit([this, &key](const auto& v) { setScalar(key, v); }, value);
+}
+
+void ColumnTable::setScalar(const std::wstring& key, bool value) {
+	if (Column* column = getCurrentCell(key, Column::Type::BOOL))
+		setBit(column->mBools, column->mLength - 1, value);
+}
+
+void ColumnTable::setScalar(const std::wstring& key, double value) {
+	if (Column* column = getCurrentCell(key, Column::Type::FLOAT))
+		column->mFloats.back() = value;
+}
+
+void ColumnTable::setScalar(const std::wstring& key, const std::wstring& value) {
+	if (Column* column = getCurrentCell(key, Column::Type::STRING)) {
+		// the current row is the last one, its string can simply be appended
+		column->mStrings += pcu::toUTF8FromUTF16(value);
+		column->mStringOffsets.back() = static_cast<int64_t>(column->mStrings.size());
+	}
+}
+
+Column* ColumnTable::getCurrentCell(const std::wstring& key, Column::Type type) {
+	if (mRowCount == 0)
+		return nullptr;
+
+	auto it = mColumnIndices.find(key);
+	if (it == mColumnIndices.end()) {
+		Column column;
+		column.mName = pcu::toUTF8FromUTF16(key);
+		column.mType = type;
+		for (size_t r = 0; r < mRowCount; r++)
+			appendNull(column);
+		mColumns.push_back(std::move(column));
+		it = mColumnIndices.emplace(key, mColumns.size() - 1).first;
+	}
+
+	Column& column = mColumns[it->second];
+	const size_t row = column.mLength - 1;
+	if (column.mType != type || column.isValid(row))
+		return nullptr;
+
+	setBit(column.mValidity, row, true);
+	column.mNullCount--;
+	return &column;
+}
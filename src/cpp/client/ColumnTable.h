@@ -0,0 +1,83 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#pragma once
+
+#include "GeneratedPayload.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Typed column of a ColumnTable. The buffers use the Arrow memory layout, which allows to export them without
+ * copying.
+ */
+struct Column {
+	enum class Type { BOOL, FLOAT, STRING };
+
+	std::string mName; // UTF-8
+	Type mType = Type::FLOAT;
+	size_t mLength = 0;
+	size_t mNullCount = 0;
+	std::vector<uint8_t> mValidity; // bit-packed, least significant bit first
+	std::vector<uint8_t> mBools;    // bit-packed like mValidity
+	std::vector<double> mFloats;
+	std::vector<int64_t> mStringOffsets{0}; // into mStrings, one entry per row plus one
+	std::string mStrings;                   // UTF-8
+
+	bool isValid(size_t row) const;
+	bool getBool(size_t row) const;
+	std::string_view getString(size_t row) const;
+};
+
+/**
+ * Collects key/value rows (e.g. the reports of the generated models) into one column per key. Each column gets the
+ * type of its first value, the rows without a value for the key and values of another type are null.
+ */
+class ColumnTable {
+public:
+	size_t getRowCount() const;
+	const std::vector<Column>& getColumns() const;
+	const Column* findColumn(std::string_view name) const;
+
+	// appends a row where all columns are null, the values are set with setValue()
+	void addRow();
+	void setValue(const std::wstring& key, const ReportValue& value);
+	void setValue(const std::wstring& key, const AttributeValue& value);
+
+private:
+	void setScalar(const std::wstring& key, bool value);
+	void setScalar(const std::wstring& key, double value);
+	void setScalar(const std::wstring& key, const std::wstring& value);
+	template <typename T>
+	void setScalar(const std::wstring& /*key*/, const AttributeArray<T>& /*value*/) {
+		// array attributes are not part of the table
+	}
+
+	// returns nullptr if the column has another type or the value of the current row is already set
+	Column* getCurrentCell(const std::wstring& key, Column::Type type);
+
+	std::vector<Column> mColumns;
+	std::unordered_map<std::wstring, size_t> mColumnIndices;
+	size_t mRowCount = 0;
+};
@@ -0,0 +1,52 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#include "EncoderOptionsCache.h"
+
+EncoderOptionsCache& EncoderOptionsCache::instance() {
+	static EncoderOptionsCache theCache;
+	return theCache;
+}
+
+AttributeMapSPtr EncoderOptionsCache::get(const std::wstring& encoderId, const std::wstring& optionsKey,
+                                          const OptionsFactory& createOptions) {
+	std::wstring key;
+	key.reserve(encoderId.size() + 1 + optionsKey.size());
+	key.append(encoderId).append(1, L'\n').append(optionsKey);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto it = mEntries.find(key);
+	if (it != mEntries.end())
+		return it->second;
+
+	AttributeMapSPtr options = createOptions();
+	if (!options)
+		return {};
+
+	if (mEntries.size() >= MAX_ENTRY_COUNT)
+		mEntries.clear();
+	mEntries.emplace(std::move(key), options);
+	return options;
+}
+
+void EncoderOptionsCache::clear() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mEntries.clear();
+}
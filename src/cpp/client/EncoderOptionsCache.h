@@ -0,0 +1,56 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#pragma once
+
+#include "types.h"
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Process-wide cache of validated encoder options. Entries are keyed by the encoder ID and a canonical key of the
+ * options (see pcu::getCanonicalKey), validating the same options again is skipped.
+ */
+class EncoderOptionsCache {
+public:
+	using OptionsFactory = std::function<AttributeMapPtr()>;
+
+	static EncoderOptionsCache& instance();
+
+	EncoderOptionsCache(const EncoderOptionsCache&) = delete;
+	EncoderOptionsCache& operator=(const EncoderOptionsCache&) = delete;
+
+	// returns the cached options or the options created by createOptions, which are cached if valid
+	AttributeMapSPtr get(const std::wstring& encoderId, const std::wstring& optionsKey,
+	                     const OptionsFactory& createOptions);
+	void clear();
+
+private:
+	EncoderOptionsCache() = default;
+
+	// the options are usually the same few dicts, the cache is simply cleared if it grows beyond this
+	static constexpr size_t MAX_ENTRY_COUNT = 256;
+
+	std::mutex mMutex;
+	std::unordered_map<std::wstring, AttributeMapSPtr> mEntries;
+};
@@ -0,0 +1,287 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#include "GeneratedBatch.h"
+#include "Aggregation.h"
+#include "logging.h"
+
+#include <algorithm>
+#include <map>
+#include <type_traits>
+#include <variant>
+
+namespace {
+
+pybind11::object toPythonKey(const GroupKey& key) {
+	return std::visit(
+	        [](const auto& k) -> pybind11::object {
+		        if constexpr (std::is_same_v<std::decay_t<decltype(k)>, std::monostate>)
+			        return pybind11::none();
+		        else
+			        return pybind11::cast(k);
+	        },
+	        key);
+}
+
+// the scalar attributes of an initial shape as a new row, int attributes become floats
+void addShapeAttributes(const prt::AttributeMap* attributeMap, ColumnTable& table) {
+	table.addRow();
+	if (attributeMap == nullptr)
+		return;
+
+	size_t keyCount = 0;
+	const wchar_t* const* keys = attributeMap->getKeys(&keyCount);
+	for (size_t k = 0; k < keyCount; k++) {
+		const wchar_t* key = keys[k];
+		switch (attributeMap->getType(key)) {
+			case prt::AttributeMap::PT_BOOL:
+				table.setValue(key, ReportValue(attributeMap->getBool(key)));
+				break;
+			case prt::AttributeMap::PT_FLOAT:
+				table.setValue(key, ReportValue(attributeMap->getFloat(key)));
+				break;
+			case prt::AttributeMap::PT_INT:
+				table.setValue(key, ReportValue(static_cast<double>(attributeMap->getInt(key))));
+				break;
+			case prt::AttributeMap::PT_STRING:
+				table.setValue(key, ReportValue(std::wstring(attributeMap->getString(key))));
+				break;
+			default: // array attributes are not part of the table
+				break;
+		}
+	}
+}
+
+} // namespace
+
+GeneratedBatch::GeneratedBatch() : mVertexOffsets(1, 0), mIndexOffsets(1, 0), mFaceOffsets(1, 0) {}
+
+GeneratedBatch::GeneratedBatch(std::vector<GeneratedPayloadPtr>&& payloads,
+                               const std::vector<AttributeMapSPtr>& shapeAttributes) {
+	mVertexOffsets.resize(payloads.size() + 1, 0);
+	mIndexOffsets.resize(payloads.size() + 1, 0);
+	mFaceOffsets.resize(payloads.size() + 1, 0);
+
+	for (size_t i = 0; i < payloads.size(); i++) {
+		const GeneratedPayload& payload = *payloads[i];
+		const size_t coordCount =
+		        payload.mLocalVertices.empty() ? payload.mVertices.size() : payload.mLocalVertices.size();
+		mVertexOffsets[i + 1] = mVertexOffsets[i] + coordCount / 3;
+		mIndexOffsets[i + 1] = mIndexOffsets[i] + payload.mIndices.size();
+		mFaceOffsets[i + 1] = mFaceOffsets[i] + payload.mFaces.size();
+	}
+
+	// one buffer after the other, the payload buffers are released as soon as they are copied
+	mVertices.resize(3 * mVertexOffsets.back());
+	for (size_t i = 0; i < payloads.size(); i++) {
+		GeneratedPayload& payload = *payloads[i];
+		auto vertexIt = mVertices.begin() + 3 * mVertexOffsets[i];
+		if (payload.mLocalVertices.empty()) {
+			std::copy(payload.mVertices.begin(), payload.mVertices.end(), vertexIt);
+		}
+		else {
+			// float32 output, back to absolute coordinates
+			for (size_t c = 0; c < payload.mLocalVertices.size(); c++)
+				*vertexIt++ = payload.mLocalVertices[c] + payload.mOrigin[c % 3];
+		}
+		Coordinates().swap(payload.mVertices);
+		std::vector<float>().swap(payload.mLocalVertices);
+	}
+
+	mIndices.resize(mIndexOffsets.back());
+	for (size_t i = 0; i < payloads.size(); i++) {
+		GeneratedPayload& payload = *payloads[i];
+		std::copy(payload.mIndices.begin(), payload.mIndices.end(), mIndices.begin() + mIndexOffsets[i]);
+		Indices().swap(payload.mIndices);
+	}
+
+	mFaces.resize(mFaceOffsets.back());
+	for (size_t i = 0; i < payloads.size(); i++) {
+		const GeneratedPayload& payload = *payloads[i];
+		std::copy(payload.mFaces.begin(), payload.mFaces.end(), mFaces.begin() + mFaceOffsets[i]);
+
+		mReports.addRow();
+		for (const auto& [key, value] : payload.mReports)
+			mReports.setValue(key, value);
+		mAttributes.addRow();
+		for (const auto& [key, value] : payload.mAttributes)
+			mAttributes.setValue(key->mName, value);
+		addShapeAttributes((i < shapeAttributes.size()) ? shapeAttributes[i].get() : nullptr, mShapeAttributes);
+
+		payloads[i].reset();
+	}
+	payloads.clear();
+}
+
+// read-only array on a buffer of the batch, the array holds a reference to the batch to keep the buffer alive
+template <typename T>
+pybind11::array_t<T> GeneratedBatch::createArrayView(const std::vector<T>& values, pybind11::ssize_t columns) const {
+	std::vector<pybind11::ssize_t> shape{static_cast<pybind11::ssize_t>(values.size()) / columns};
+	if (columns > 1)
+		shape.push_back(columns);
+
+	using BatchPtr = std::shared_ptr<const GeneratedBatch>;
+	pybind11::capsule base(new BatchPtr(shared_from_this()), [](void* p) { delete static_cast<BatchPtr*>(p); });
+	pybind11::array_t<T> array(shape, values.data(), base);
+	array.attr("setflags")(pybind11::arg("write") = false);
+	return array;
+}
+
+// one NumPy masked array per column, the null entries are masked
+pybind11::dict GeneratedBatch::toPythonTable(const ColumnTable& table) const {
+	const pybind11::object maskedArray = pybind11::module_::import("numpy.ma").attr("MaskedArray");
+
+	pybind11::dict dict;
+	for (const Column& column : table.getColumns()) {
+		pybind11::array_t<bool> mask(static_cast<pybind11::ssize_t>(column.mLength));
+		bool* maskData = mask.mutable_data();
+		for (size_t r = 0; r < column.mLength; r++)
+			maskData[r] = !column.isValid(r);
+
+		pybind11::object values;
+		switch (column.mType) {
+			case Column::Type::BOOL: {
+				pybind11::array_t<bool> bools(static_cast<pybind11::ssize_t>(column.mLength));
+				bool* boolData = bools.mutable_data();
+				for (size_t r = 0; r < column.mLength; r++)
+					boolData[r] = column.getBool(r);
+				values = std::move(bools);
+				break;
+			}
+			case Column::Type::FLOAT:
+				values = createArrayView(column.mFloats);
+				break;
+			default: {
+				pybind11::list strings(column.mLength);
+				for (size_t r = 0; r < column.mLength; r++)
+					strings[r] = pybind11::str(column.getString(r).data(), column.getString(r).size());
+				values = pybind11::module_::import("numpy").attr("array")(strings, pybind11::arg("dtype") = "object");
+				break;
+			}
+		}
+		dict[pybind11::str(column.mName)] = maskedArray(values, pybind11::arg("mask") = mask);
+	}
+	return dict;
+}
+
+pybind11::dict GeneratedBatch::aggregateReports(const std::string& reportKey,
+                                                const std::vector<std::string>& operations,
+                                                const pybind11::object& groupBy) const {
+	const Column* values = mReports.findColumn(reportKey);
+	if (values == nullptr || values->mType == Column::Type::STRING) {
+		LOG_ERR << "no float or bool report '" << reportKey << "' to aggregate.";
+		return {};
+	}
+
+	std::vector<AggregateOperation> aggregateOperations(operations.size());
+	for (size_t i = 0; i < operations.size(); i++) {
+		if (!getAggregateOperation(operations[i], aggregateOperations[i])) {
+			LOG_ERR << "unknown aggregate operation '" << operations[i]
+			        << "', expected 'sum', 'mean', 'min', 'max' or 'count'.";
+			return {};
+		}
+	}
+
+	// the input shape attributes first, they are also set for attributes which the rule does not evaluate
+	const Column* groupColumn = nullptr;
+	if (!groupBy.is_none()) {
+		const std::string groupKey = pybind11::str(groupBy);
+		for (const ColumnTable* table : {&mShapeAttributes, &mAttributes, &mReports}) {
+			groupColumn = table->findColumn(groupKey);
+			if (groupColumn != nullptr)
+				break;
+		}
+		if (groupColumn == nullptr) {
+			LOG_ERR << "no shape attribute, rule attribute or report '" << groupKey << "' to group by.";
+			return {};
+		}
+	}
+
+	auto toPythonDict = [&operations, &aggregateOperations](const Aggregate& aggregate) {
+		pybind11::dict dict;
+		for (size_t i = 0; i < operations.size(); i++) {
+			if (aggregateOperations[i] == AggregateOperation::COUNT)
+				dict[pybind11::str(operations[i])] = pybind11::int_(aggregate.mCount);
+			else
+				dict[pybind11::str(operations[i])] = pybind11::float_(aggregate.get(aggregateOperations[i]));
+		}
+		return dict;
+	};
+
+	const std::map<GroupKey, Aggregate> groups = aggregateColumn(*values, groupColumn);
+	if (groupColumn == nullptr)
+		return toPythonDict(groups.empty() ? Aggregate() : groups.begin()->second);
+
+	pybind11::dict result;
+	for (const auto& [key, aggregate] : groups)
+		result[toPythonKey(key)] = toPythonDict(aggregate);
+	return result;
+}
+
+size_t GeneratedBatch::getModelCount() const {
+	return mVertexOffsets.size() - 1;
+}
+const Coordinates& GeneratedBatch::getVertices() const {
+	return mVertices;
+}
+const Indices& GeneratedBatch::getIndices() const {
+	return mIndices;
+}
+const Indices& GeneratedBatch::getFaces() const {
+	return mFaces;
+}
+const std::vector<uint64_t>& GeneratedBatch::getVertexOffsets() const {
+	return mVertexOffsets;
+}
+const std::vector<uint64_t>& GeneratedBatch::getIndexOffsets() const {
+	return mIndexOffsets;
+}
+const std::vector<uint64_t>& GeneratedBatch::getFaceOffsets() const {
+	return mFaceOffsets;
+}
+const ColumnTable& GeneratedBatch::getReports() const {
+	return mReports;
+}
+const ColumnTable& GeneratedBatch::getAttributes() const {
+	return mAttributes;
+}
+pybind11::dict GeneratedBatch::getReportTable() const {
+	return toPythonTable(mReports);
+}
+pybind11::dict GeneratedBatch::getAttributeTable() const {
+	return toPythonTable(mAttributes);
+}
+pybind11::array_t<double> GeneratedBatch::getVerticesArray() const {
+	return createArrayView(mVertices, 3);
+}
+pybind11::array_t<uint32_t> GeneratedBatch::getIndicesArray() const {
+	return createArrayView(mIndices);
+}
+pybind11::array_t<uint32_t> GeneratedBatch::getFacesArray() const {
+	return createArrayView(mFaces);
+}
+pybind11::array_t<uint64_t> GeneratedBatch::getVertexOffsetsArray() const {
+	return createArrayView(mVertexOffsets);
+}
+pybind11::array_t<uint64_t> GeneratedBatch::getIndexOffsetsArray() const {
+	return createArrayView(mIndexOffsets);
+}
+pybind11::array_t<uint64_t> GeneratedBatch::getFaceOffsetsArray() const {
+	return createArrayView(mFaceOffsets);
+}
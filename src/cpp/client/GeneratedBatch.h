@@ -0,0 +1,84 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#pragma once
+
+#include "ColumnTable.h"
+#include "GeneratedPayload.h"
+#include "types.h"
+
+#include "pybind11/numpy.h"
+#include "pybind11/pybind11.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Geometry of all models of a generate call in concatenated buffers. The offset arrays have one entry per model plus
+ * one, the data of model i is in [offsets[i], offsets[i + 1]). The vertex indices are relative to the first vertex
+ * of their model, like in GeneratedModel. The scalar reports, evaluated rule attributes and input shape attributes
+ * are collected in one table each.
+ */
+class GeneratedBatch : public std::enable_shared_from_this<GeneratedBatch> {
+public:
+	GeneratedBatch();
+	// releases the payloads while copying, the shape attributes are the inputs of the initial shapes
+	GeneratedBatch(std::vector<GeneratedPayloadPtr>&& payloads, const std::vector<AttributeMapSPtr>& shapeAttributes);
+
+	size_t getModelCount() const;
+	const Coordinates& getVertices() const;
+	const Indices& getIndices() const;
+	const Indices& getFaces() const;
+	const std::vector<uint64_t>& getVertexOffsets() const;
+	const std::vector<uint64_t>& getIndexOffsets() const;
+	const std::vector<uint64_t>& getFaceOffsets() const;
+	const ColumnTable& getReports() const;
+	const ColumnTable& getAttributes() const;
+
+	pybind11::array_t<double> getVerticesArray() const;
+	pybind11::array_t<uint32_t> getIndicesArray() const;
+	pybind11::array_t<uint32_t> getFacesArray() const;
+	pybind11::array_t<uint64_t> getVertexOffsetsArray() const;
+	pybind11::array_t<uint64_t> getIndexOffsetsArray() const;
+	pybind11::array_t<uint64_t> getFaceOffsetsArray() const;
+	pybind11::dict getReportTable() const;
+	pybind11::dict getAttributeTable() const;
+	pybind11::dict aggregateReports(const std::string& reportKey, const std::vector<std::string>& operations,
+	                                const pybind11::object& groupBy) const;
+
+private:
+	template <typename T>
+	pybind11::array_t<T> createArrayView(const std::vector<T>& values, pybind11::ssize_t columns = 1) const;
+	pybind11::dict toPythonTable(const ColumnTable& table) const;
+
+	Coordinates mVertices;
+	Indices mIndices;
+	Indices mFaces;
+	std::vector<uint64_t> mVertexOffsets; // in vertices, not coordinates
+	std::vector<uint64_t> mIndexOffsets;
+	std::vector<uint64_t> mFaceOffsets;
+	ColumnTable mReports;
+	ColumnTable mAttributes;
+	ColumnTable mShapeAttributes;
+};
+
+using GeneratedBatchPtr = std::shared_ptr<GeneratedBatch>;
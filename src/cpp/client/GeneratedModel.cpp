@@ -19,6 +19,23 @@
 
 #include "GeneratedModel.h"
 
+#include <algorithm>
+
+namespace {
+
+// read-only array on the payload buffer, the array holds a reference to the payload to keep the buffer alive
+template <typename T>
+pybind11::array_t<T> createArrayView(const std::vector<T>& values, const std::vector<pybind11::ssize_t>& shape,
+                                     const GeneratedPayloadPtr& payload) {
+	pybind11::capsule base(new GeneratedPayloadPtr(payload),
+	                       [](void* p) { delete static_cast<GeneratedPayloadPtr*>(p); });
+	pybind11::array_t<T> array(shape, values.data(), base);
+	array.attr("setflags")(pybind11::arg("write") = false);
+	return array;
+}
+
+} // namespace
+
 GeneratedModel::GeneratedModel(const size_t& initShapeIdx, GeneratedPayloadPtr payload)
     : mInitialShapeIndex(initShapeIdx), mPayload(payload) {}
 
@@ -34,15 +51,71 @@ const Indices& GeneratedModel::getIndices() const {
 const Indices& GeneratedModel::getFaces() const {
 	return mPayload->mFaces;
 }
-const pybind11::dict& GeneratedModel::getReport() const {
-	return mPayload->mCGAReport;
+pybind11::array GeneratedModel::getVerticesArray() const {
+	if (!mPayload->mLocalVertices.empty()) {
+		const auto vertexCount = static_cast<pybind11::ssize_t>(mPayload->mLocalVertices.size() / 3);
+		return createArrayView(mPayload->mLocalVertices, {vertexCount, 3}, mPayload);
+	}
+	const auto vertexCount = static_cast<pybind11::ssize_t>(mPayload->mVertices.size() / 3);
+	return createArrayView(mPayload->mVertices, {vertexCount, 3}, mPayload);
+}
+const std::array<double, 3>& GeneratedModel::getOrigin() const {
+	return mPayload->mOrigin;
+}
+pybind11::bytes GeneratedModel::getCompactGeometry() const {
+	const std::vector<uint8_t>& buffer = mPayload->mCompactGeometry;
+	return pybind11::bytes(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+}
+pybind11::array_t<uint32_t> GeneratedModel::getIndicesArray() const {
+	return createArrayView(mPayload->mIndices, {static_cast<pybind11::ssize_t>(mPayload->mIndices.size())}, mPayload);
+}
+pybind11::array_t<uint32_t> GeneratedModel::getFacesArray() const {
+	return createArrayView(mPayload->mFaces, {static_cast<pybind11::ssize_t>(mPayload->mFaces.size())}, mPayload);
+}
+pybind11::list GeneratedModel::getInstances() const {
+	pybind11::list instances(mPayload->mInstances.size());
+	for (size_t i = 0; i < mPayload->mInstances.size(); i++) {
+		const GeometryInstance& instance = mPayload->mInstances[i];
+		// the transformation is column-major, which is the Fortran order of a 4x4 array
+		pybind11::array_t<double, pybind11::array::f_style> transformation({4, 4});
+		std::copy(instance.mTransformation.begin(), instance.mTransformation.end(), transformation.mutable_data());
+		instances[i] = pybind11::make_tuple(instance.mPrototypeId, std::move(transformation));
+	}
+	return instances;
+}
+PrototypeTablePtr GeneratedModel::getPrototypes() const {
+	return mPayload->mPrototypes;
+}
+pybind11::array_t<uint32_t> GeneratedModel::getFaceShapeIdsArray() const {
+	const auto faceCount = static_cast<pybind11::ssize_t>(mPayload->mFaceShapeIds.size());
+	return createArrayView(mPayload->mFaceShapeIds, {faceCount}, mPayload);
+}
+const std::vector<std::wstring>& GeneratedModel::getShapeNames() const {
+	return mPayload->mShapeNames;
+}
+pybind11::dict GeneratedModel::getSummary() const {
+	pybind11::dict dict;
+	if (!mPayload->mSummary)
+		return dict;
+
+	const GeometrySummary& summary = *mPayload->mSummary;
+	dict["footprintArea"] = summary.mFootprintArea;
+	dict["surfaceArea"] = summary.mSurfaceArea;
+	dict["volume"] = summary.mVolume;
+	dict["height"] = summary.mHeight;
+	dict["boundingBoxMin"] = pybind11::make_tuple(summary.mMin[0], summary.mMin[1], summary.mMin[2]);
+	dict["boundingBoxMax"] = pybind11::make_tuple(summary.mMax[0], summary.mMax[1], summary.mMax[2]);
+	return dict;
+}
+pybind11::dict GeneratedModel::getReport() const {
+	return mPayload->getReport();
 }
-const std::wstring& GeneratedModel::getCGAPrints() const {
-	return mPayload->mCGAPrints;
+pybind11::str GeneratedModel::getCGAPrints() const {
+	return mPayload->getCGAPrints();
 }
-const std::vector<std::wstring>& GeneratedModel::getCGAErrors() const {
-	return mPayload->mCGAErrors;
+pybind11::list GeneratedModel::getCGAErrors() const {
+	return mPayload->getCGAErrors();
 }
-const pybind11::dict& GeneratedModel::getAttributes() const {
-	return mPayload->mAttrVal;
+pybind11::dict GeneratedModel::getAttributes() const {
+	return mPayload->getAttributes();
 }
@@ -22,8 +22,10 @@
 #include "GeneratedPayload.h"
 #include "types.h"
 
+#include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <vector>
@@ -38,10 +40,20 @@ public:
 	const Coordinates& getVertices() const;
 	const Indices& getIndices() const;
 	const Indices& getFaces() const;
-	const pybind11::dict& getReport() const;
-	const std::wstring& getCGAPrints() const;
-	const std::vector<std::wstring>& getCGAErrors() const;
-	const pybind11::dict& getAttributes() const;
+	pybind11::array getVerticesArray() const;
+	const std::array<double, 3>& getOrigin() const;
+	pybind11::bytes getCompactGeometry() const;
+	pybind11::array_t<uint32_t> getIndicesArray() const;
+	pybind11::array_t<uint32_t> getFacesArray() const;
+	pybind11::list getInstances() const;
+	PrototypeTablePtr getPrototypes() const;
+	pybind11::dict getSummary() const;
+	pybind11::array_t<uint32_t> getFaceShapeIdsArray() const;
+	const std::vector<std::wstring>& getShapeNames() const;
+	pybind11::dict getReport() const;
+	pybind11::str getCGAPrints() const;
+	pybind11::list getCGAErrors() const;
+	pybind11::dict getAttributes() const;
 
 private:
 	size_t mInitialShapeIndex;
@@ -0,0 +1,177 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#include "GeneratedPayload.h"
+
+#include "pybind11/numpy.h"
+#include "pybind11/stl.h"
+
+#include <algorithm>
+#include <functional>
+#include <string_view>
+
+namespace py = pybind11;
+
+namespace {
+
+template <typename T>
+py::object toPythonValue(const T& value) {
+	return py::cast(value);
+}
+
+// float and bool arrays become NumPy arrays which take over the values
+template <typename T>
+py::object toNumpyArray(AttributeArray<T>& array, const py::dtype& dtype) {
+	const size_t nRows = std::max<size_t>(array.mRows, 1);
+	const size_t nCols = array.mValues.size() / nRows;
+	std::vector<py::ssize_t> shape{static_cast<py::ssize_t>(nCols)};
+	if (nRows > 1)
+		shape.insert(shape.begin(), static_cast<py::ssize_t>(nRows));
+
+	auto* values = new std::vector<T>(std::move(array.mValues));
+	py::capsule base(values, [](void* v) { delete static_cast<std::vector<T>*>(v); });
+	return py::array(dtype, shape, values->data(), base);
+}
+
+py::object toPythonValue(FloatArray& array) {
+	return toNumpyArray(array, py::dtype::of<double>());
+}
+
+py::object toPythonValue(BoolArray& array) {
+	return toNumpyArray(array, py::dtype::of<bool>()); // the bytes are 0 or 1
+}
+
+template <typename T>
+py::object toPythonValue(const AttributeArray<T>& array) {
+	const size_t nRows = std::max<size_t>(array.mRows, 1);
+	const size_t nCols = array.mValues.size() / nRows;
+
+	auto toPythonList = [&array](size_t first, size_t count) {
+		py::list values(count);
+		for (size_t i = 0; i < count; i++)
+			values[i] = toPythonValue(array.mValues[first + i]);
+		return values;
+	};
+
+	if (nRows > 1) {
+		py::list rows(nRows);
+		for (size_t r = 0; r < nRows; r++)
+			rows[r] = toPythonList(r * nCols, nCols);
+		return std::move(rows);
+	}
+
+	return toPythonList(0, nCols);
+}
+
+py::dict toPythonDict(const Reports& reports) {
+	py::dict dict;
+	for (const auto& [key, value] : reports) {
+		dict[py::cast(key)] = std::visit([](const auto& v) { return toPythonValue(v); }, value);
+	}
+	return dict;
+}
+
+py::dict toPythonDict(AttributeValues& attributes, PythonAttributeKeys& attributeKeys) {
+	py::dict dict;
+	for (auto& [key, value] : attributes) {
+		py::object& pyKey = attributeKeys[key];
+		if (!pyKey)
+			pyKey = py::cast(key->mName);
+		dict[pyKey] = std::visit([](auto& v) { return toPythonValue(v); }, value);
+	}
+	return dict;
+}
+
+template <typename T>
+void hashBuffer(const std::vector<T>& buffer, size_t& hash) {
+	const std::string_view bytes(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(T));
+	hash = hash * 31 + std::hash<std::string_view>{}(bytes);
+}
+
+} // namespace
+
+uint32_t PrototypeTable::add(Prototype&& prototype) {
+	size_t hash = 0;
+	hashBuffer(prototype.mVertices, hash);
+	hashBuffer(prototype.mIndices, hash);
+	hashBuffer(prototype.mFaces, hash);
+
+	std::vector<uint32_t>& candidates = mByContent[hash];
+	for (const uint32_t prototypeId : candidates) {
+		const Prototype& other = mPrototypes[prototypeId];
+		if (other.mVertices == prototype.mVertices && other.mIndices == prototype.mIndices &&
+		    other.mFaces == prototype.mFaces)
+			return prototypeId;
+	}
+
+	const auto prototypeId = static_cast<uint32_t>(mPrototypes.size());
+	mPrototypes.push_back(std::move(prototype));
+	candidates.push_back(prototypeId);
+	return prototypeId;
+}
+
+size_t PrototypeTable::getPrototypeCount() const {
+	return mPrototypes.size();
+}
+
+const Coordinates& PrototypeTable::getVertices(size_t prototypeId) const {
+	return mPrototypes.at(prototypeId).mVertices;
+}
+
+const Indices& PrototypeTable::getIndices(size_t prototypeId) const {
+	return mPrototypes.at(prototypeId).mIndices;
+}
+
+const Indices& PrototypeTable::getFaces(size_t prototypeId) const {
+	return mPrototypes.at(prototypeId).mFaces;
+}
+
+pybind11::dict GeneratedPayload::getReport() {
+	if (!mCGAReport) {
+		mCGAReport = toPythonDict(mReports);
+		Reports().swap(mReports);
+	}
+	return pybind11::reinterpret_borrow<pybind11::dict>(mCGAReport);
+}
+
+pybind11::dict GeneratedPayload::getAttributes() {
+	if (!mAttrVal) {
+		if (!mPythonAttributeKeys)
+			mPythonAttributeKeys = std::make_shared<PythonAttributeKeys>();
+		mAttrVal = toPythonDict(mAttributes, *mPythonAttributeKeys);
+		AttributeValues().swap(mAttributes);
+	}
+	return pybind11::reinterpret_borrow<pybind11::dict>(mAttrVal);
+}
+
+pybind11::str GeneratedPayload::getCGAPrints() {
+	if (!mPythonCGAPrints) {
+		mPythonCGAPrints = py::cast(mCGAPrints);
+		std::wstring().swap(mCGAPrints);
+	}
+	return pybind11::reinterpret_borrow<pybind11::str>(mPythonCGAPrints);
+}
+
+pybind11::list GeneratedPayload::getCGAErrors() {
+	if (!mPythonCGAErrors) {
+		mPythonCGAErrors = py::cast(mCGAErrors);
+		std::vector<std::wstring>().swap(mCGAErrors);
+	}
+	return pybind11::reinterpret_borrow<pybind11::list>(mPythonCGAErrors);
+}
@@ -19,22 +19,106 @@
 
 #pragma once
 
+#include "AttributeKeyTable.h"
 #include "types.h"
 
+#include "encoder/IPyCallbacks.h"
+
 #include "pybind11/pybind11.h"
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
+template <typename T>
+struct AttributeArray {
+	std::vector<T> mValues;
+	size_t mRows = 1;
+};
+
+// std::vector<bool> is not contiguous, therefore bool arrays are stored byte-wise
+using BoolArray = AttributeArray<uint8_t>;
+using FloatArray = AttributeArray<double>;
+using StringArray = AttributeArray<std::wstring>;
+
+using ReportValue = std::variant<bool, double, std::wstring>;
+using AttributeValue = std::variant<bool, double, std::wstring, BoolArray, FloatArray, StringArray>;
+
+using Reports = std::vector<std::pair<std::wstring, ReportValue>>;
+using AttributeValues = std::vector<std::pair<const AttributeKey*, AttributeValue>>;
+
+// Python objects of the attribute keys, shared by the payloads converted together
+using PythonAttributeKeys = std::unordered_map<const AttributeKey*, pybind11::object>;
+
+/**
+ * The prototype meshes of an instancing generate call, shared by the generated models of the call.
+ */
+struct PrototypeTable {
+	struct Prototype {
+		Coordinates mVertices;
+		Indices mIndices;
+		Indices mFaces;
+	};
+	std::vector<Prototype> mPrototypes;
+	std::unordered_map<size_t, std::vector<uint32_t>> mByContent; // prototype IDs by mesh hash, see add()
+
+	// adds the prototype unless the table already contains an identical mesh, returns its prototype ID
+	uint32_t add(Prototype&& prototype);
+
+	size_t getPrototypeCount() const;
+	const Coordinates& getVertices(size_t prototypeId) const;
+	const Indices& getIndices(size_t prototypeId) const;
+	const Indices& getFaces(size_t prototypeId) const;
+};
+
+using PrototypeTablePtr = std::shared_ptr<PrototypeTable>;
+
+struct GeometryInstance {
+	uint32_t mPrototypeId = 0;
+	std::array<double, 16> mTransformation; // column-major 4x4 matrix
+};
+
+/**
+ * Collects the generation result of one initial shape. The callbacks only fill the native members, as PRT calls them
+ * from its own threads without holding the GIL. The Python objects are only created on first access by the getters,
+ * which then release the native data. Payloads with Python objects must be destroyed while holding the GIL.
+ */
 struct GeneratedPayload {
 	Coordinates mVertices;
+	std::vector<float> mLocalVertices; // float32 output instead of mVertices, relative to mOrigin
+	std::array<double, 3> mOrigin{};
+	std::vector<uint8_t> mCompactGeometry; // compact output instead of the vertex and index buffers
 	Indices mIndices;
 	Indices mFaces;
-	pybind11::dict mCGAReport;
+	std::vector<GeometryInstance> mInstances;
+	PrototypeTablePtr mPrototypes; // only set if there are instances
+	std::optional<GeometrySummary> mSummary;
+	Indices mFaceShapeIds;
+	std::vector<std::wstring> mShapeNames;
+	Reports mReports;
 	std::wstring mCGAPrints;
 	std::vector<std::wstring> mCGAErrors;
-	pybind11::dict mAttrVal;
+	AttributeValues mAttributes;
+	AttributeKeyTableConstPtr mAttributeKeys; // owns the keys of mAttributes
+
+	std::shared_ptr<PythonAttributeKeys> mPythonAttributeKeys; // shared by the payloads of a generate call
+
+	pybind11::object mCGAReport;
+	pybind11::object mAttrVal;
+	pybind11::object mPythonCGAPrints;
+	pybind11::object mPythonCGAErrors;
+
+	// require the GIL
+	pybind11::dict getReport();
+	pybind11::dict getAttributes();
+	pybind11::str getCGAPrints();
+	pybind11::list getCGAErrors();
 };
 
-using GeneratedPayloadPtr = std::shared_ptr<GeneratedPayload>;
\ No newline at end of file
+using GeneratedPayloadPtr = std::shared_ptr<GeneratedPayload>;
@@ -18,11 +18,20 @@
  */
 
 #include "ModelGenerator.h"
+#include "EncoderOptionsCache.h"
 #include "PRTContext.h"
 #include "PyCallbacks.h"
+#include "PythonLogHandler.h"
+#include "ThreadPool.h"
 #include "logging.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace {
 
@@ -34,19 +43,286 @@ const std::wstring ENCODER_ID_PYTHON = L"com.esri.pyprt.PyEncoder";
 
 constexpr const char* ENC_OPT_OUTPUT_PATH = "outputPath";
 
-void extractMainShapeAttributes(const py::dict& shapeAttr, int32_t& seed, std::wstring& shapeName,
-                                AttributeMapPtr& convertShapeAttr) {
-	convertShapeAttr = pcu::createAttributeMapFromPythonDict(
-	        shapeAttr, *(AttributeMapBuilderPtr(prt::AttributeMapBuilder::create())));
-	if (convertShapeAttr) {
-		if (convertShapeAttr->hasKey(L"seed") && convertShapeAttr->getType(L"seed") == prt::AttributeMap::PT_INT)
-			seed = convertShapeAttr->getInt(L"seed");
-		if (convertShapeAttr->hasKey(L"shapeName") &&
-		    convertShapeAttr->getType(L"shapeName") == prt::AttributeMap::PT_STRING)
-			shapeName = convertShapeAttr->getString(L"shapeName");
+// PyEncoder options whose geometry cannot be concatenated into a GeneratedBatch
+const wchar_t* const BATCH_UNSUPPORTED_OPTIONS[] = {L"compactGeometry", L"instancing"};
+
+// validated options are reused across calls as long as the options dict can be represented by a canonical key
+AttributeMapSPtr getValidatedEncoderOptions(const std::wstring& encoderId, const py::dict& options,
+                                            prt::AttributeMapBuilder& builder) {
+	auto createOptions = [&]() {
+		const AttributeMapPtr unvalidatedOptions{pcu::createAttributeMapFromPythonDict(options, builder)};
+		return pcu::createValidatedOptions(encoderId, unvalidatedOptions);
+	};
+
+	std::wstring optionsKey;
+	if (!pcu::getCanonicalKey(options, optionsKey))
+		return createOptions();
+	return EncoderOptionsCache::instance().get(encoderId, optionsKey, createOptions);
+}
+
+// the encoders which are run next to the geometry encoder, selected with the auxiliaryOutputs argument
+enum AuxiliaryOutput : uint32_t {
+	AUX_OUTPUT_REPORT = 1 << 0,
+	AUX_OUTPUT_PRINT = 1 << 1,
+	AUX_OUTPUT_ERRORS = 1 << 2,
+	AUX_OUTPUT_ATTRIBUTES = 1 << 3,
+	AUX_OUTPUT_ALL = AUX_OUTPUT_REPORT | AUX_OUTPUT_PRINT | AUX_OUTPUT_ERRORS | AUX_OUTPUT_ATTRIBUTES
+};
+
+struct AuxiliaryEncoder {
+	const char* mOutputName;
+	AuxiliaryOutput mOutput;
+	const std::wstring& mEncoderId;
+};
+
+const AuxiliaryEncoder AUXILIARY_ENCODERS[] = {{"report", AUX_OUTPUT_REPORT, ENCODER_ID_CGA_REPORT},
+                                               {"print", AUX_OUTPUT_PRINT, ENCODER_ID_CGA_PRINT},
+                                               {"errors", AUX_OUTPUT_ERRORS, ENCODER_ID_CGA_ERROR},
+                                               {"attributes", AUX_OUTPUT_ATTRIBUTES, ENCODER_ID_ATTR_EVAL}};
+
+// None selects all auxiliary outputs, otherwise a collection of output names is expected
+bool getAuxiliaryOutputs(const py::object& outputNames, uint32_t& outputs) {
+	if (outputNames.is_none()) {
+		outputs = AUX_OUTPUT_ALL;
+		return true;
+	}
+
+	py::list names;
+	if (py::isinstance<py::str>(outputNames))
+		names.append(outputNames);
+	else
+		names = py::list(outputNames);
+
+	outputs = 0;
+	for (const py::handle& name : names) {
+		const std::string outputName = py::str(name);
+		const auto encoder =
+		        std::find_if(std::begin(AUXILIARY_ENCODERS), std::end(AUXILIARY_ENCODERS),
+		                     [&outputName](const AuxiliaryEncoder& e) { return outputName == e.mOutputName; });
+		if (encoder == std::end(AUXILIARY_ENCODERS)) {
+			LOG_ERR << "unknown auxiliary output '" << outputName
+			        << "', expected 'report', 'print', 'errors' or 'attributes'.";
+			return false;
+		}
+		outputs |= encoder->mOutput;
+	}
+	return true;
+}
+
+// number of shards per thread if the shard size is chosen automatically, gives the work-stealing room to balance
+constexpr size_t SHARDS_PER_THREAD = 4;
+
+void extractMainShapeAttributes(const AttributeMapSPtr& shapeAttr, int32_t& seed, std::wstring& shapeName) {
+	if (shapeAttr) {
+		if (shapeAttr->hasKey(L"seed") && shapeAttr->getType(L"seed") == prt::AttributeMap::PT_INT)
+			seed = shapeAttr->getInt(L"seed");
+		if (shapeAttr->hasKey(L"shapeName") && shapeAttr->getType(L"shapeName") == prt::AttributeMap::PT_STRING)
+			shapeName = shapeAttr->getString(L"shapeName");
 	}
 }
 
+// a hash over the keys and values of a shape attribute dictionary, false if a value is not hashable
+bool hashShapeAttributes(const py::dict& shapeAttr, size_t& hash) {
+	auto hashValue = [](const py::handle& value, size_t& valueHash) {
+		if (py::isinstance<py::list>(value)) {
+			valueHash = py::len(value);
+			for (const py::handle& item : value.cast<py::list>()) {
+				const Py_hash_t itemHash = PyObject_Hash(item.ptr());
+				if (itemHash == -1)
+					return false;
+				valueHash = valueHash * 1000003 ^ static_cast<size_t>(itemHash);
+			}
+			return true;
+		}
+		const Py_hash_t h = PyObject_Hash(value.ptr());
+		valueHash = static_cast<size_t>(h);
+		return h != -1;
+	};
+
+	hash = 0;
+	for (const auto& item : shapeAttr) {
+		size_t valueHash = 0;
+		const Py_hash_t keyHash = PyObject_Hash(item.first.ptr());
+		if (keyHash == -1 || !hashValue(item.second, valueHash)) {
+			PyErr_Clear();
+			return false;
+		}
+		hash += static_cast<size_t>(keyHash) * 31 + valueHash; // independent of the item order
+	}
+	return true;
+}
+
+// values are only the same if they also have the same types (unlike in Python, 1 and True must not be merged)
+bool isSameShapeAttributeValue(const py::handle& a, const py::handle& b) {
+	if (Py_TYPE(a.ptr()) != Py_TYPE(b.ptr()))
+		return false;
+	if (py::isinstance<py::list>(a)) {
+		const py::list listA = a.cast<py::list>();
+		const py::list listB = b.cast<py::list>();
+		if (listA.size() != listB.size())
+			return false;
+		for (size_t i = 0; i < listA.size(); i++) {
+			if (!isSameShapeAttributeValue(listA[i], listB[i]))
+				return false;
+		}
+		return true;
+	}
+	const int equal = PyObject_RichCompareBool(a.ptr(), b.ptr(), Py_EQ);
+	if (equal < 0)
+		PyErr_Clear();
+	return equal == 1;
+}
+
+bool isSameShapeAttributes(const py::dict& a, const py::dict& b) {
+	if (a.size() != b.size())
+		return false;
+	for (const auto& item : a) {
+		PyObject* otherValue = PyDict_GetItem(b.ptr(), item.first.ptr()); // borrowed
+		if (otherValue == nullptr || !isSameShapeAttributeValue(item.second, otherValue))
+			return false;
+	}
+	return true;
+}
+
+std::wstring getTypeName(prt::AnnotationArgumentType type) {
+	switch (type) {
+		case prt::AAT_BOOL:
+			return L"bool";
+		case prt::AAT_FLOAT:
+			return L"float";
+		case prt::AAT_INT:
+			return L"int";
+		case prt::AAT_STR:
+			return L"string";
+		case prt::AAT_BOOL_ARRAY:
+			return L"bool array";
+		case prt::AAT_FLOAT_ARRAY:
+			return L"float array";
+		case prt::AAT_STR_ARRAY:
+			return L"string array";
+		default:
+			return L"unknown";
+	}
+}
+
+/**
+ * Converts the shape attribute dictionaries according to the declared types of the rule attributes. Each distinct
+ * dictionary is only converted once: the same dictionary object, or a dictionary with the same content as one converted
+ * before, reuses the converted attribute map.
+ */
+class ShapeAttributesConverter {
+public:
+	explicit ShapeAttributesConverter(const RuleAttributeTypes& attributeTypes) : mAttributeTypes(attributeTypes) {}
+
+	// returns an empty pointer if a value does not match the declared type of its rule attribute
+	AttributeMapSPtr convert(const py::dict& shapeAttr) {
+		const auto sameObject = mByObject.find(shapeAttr.ptr());
+		if (sameObject != mByObject.end())
+			return sameObject->second;
+
+		size_t hash = 0;
+		const bool hashable = hashShapeAttributes(shapeAttr, hash);
+		if (hashable) {
+			for (const auto& [otherShapeAttr, attributeMap] : mByContent[hash]) {
+				if (isSameShapeAttributes(shapeAttr, otherShapeAttr)) {
+					mByObject.emplace(shapeAttr.ptr(), attributeMap);
+					mKeepAlive.push_back(shapeAttr);
+					return attributeMap;
+				}
+			}
+		}
+
+		for (const auto& item : shapeAttr) {
+			const Key& key = getKey(item.first);
+			if (!pcu::setTypedAttributeFromPythonValue(key.mName, key.mType, item.second, *mBuilder)) {
+				LOG_ERR << L"shape attribute " << key.mName << L" must be of type " << getTypeName(key.mType);
+				mBuilder->clear();
+				return {};
+			}
+		}
+		const AttributeMapSPtr attributeMap{AttributeMapPtr(mBuilder->createAttributeMapAndReset())};
+
+		mByObject.emplace(shapeAttr.ptr(), attributeMap);
+		mKeepAlive.push_back(shapeAttr);
+		if (hashable)
+			mByContent[hash].emplace_back(shapeAttr, attributeMap);
+		return attributeMap;
+	}
+
+private:
+	struct Key {
+		std::wstring mName;
+		prt::AnnotationArgumentType mType = prt::AAT_UNKNOWN;
+	};
+
+	// the keys of dictionary literals are interned Python strings, the lookup by object is enough for most of them
+	const Key& getKey(const py::handle& key) {
+		auto it = mKeys.find(key.ptr());
+		if (it == mKeys.end()) {
+			Key newKey;
+			newKey.mName = key.cast<std::wstring>();
+			const auto attributeType = mAttributeTypes.find(newKey.mName);
+			if (attributeType != mAttributeTypes.end())
+				newKey.mType = attributeType->second;
+			it = mKeys.emplace(key.ptr(), std::move(newKey)).first;
+			mKeepAlive.push_back(py::reinterpret_borrow<py::object>(key));
+		}
+		return it->second;
+	}
+
+	const RuleAttributeTypes& mAttributeTypes;
+	AttributeMapBuilderPtr mBuilder{prt::AttributeMapBuilder::create()};
+	std::unordered_map<const PyObject*, Key> mKeys;
+	std::unordered_map<const PyObject*, AttributeMapSPtr> mByObject;
+	std::unordered_map<size_t, std::vector<std::pair<py::dict, AttributeMapSPtr>>> mByContent;
+	std::vector<py::object> mKeepAlive; // the object addresses must stay valid during the conversion
+};
+
+/**
+ * Converts the shape attributes of the initial shapes [firstShape, firstShape + shapeCount). The shape attributes are
+ * either a list with one dictionary per initial shape (or a single dictionary for all initial shapes) or a dictionary
+ * of attribute columns with one value per initial shape.
+ */
+bool convertShapeAttributes(const py::object& shapeAttributes, const RuleAttributeTypes& attributeTypes,
+                            size_t totalShapeCount, size_t firstShape, size_t shapeCount,
+                            std::vector<AttributeMapSPtr>& convertedShapeAttr) {
+	if (py::isinstance<py::dict>(shapeAttributes)) {
+		std::vector<AttributeMapPtr> attributeMaps;
+		if (!pcu::createAttributeMapsFromPythonColumns(shapeAttributes.cast<py::dict>(), attributeTypes, firstShape,
+		                                               shapeCount, attributeMaps))
+			return false;
+		convertedShapeAttr.resize(shapeCount);
+		std::move(attributeMaps.begin(), attributeMaps.end(), convertedShapeAttr.begin());
+		return true;
+	}
+
+	if (!py::isinstance<py::sequence>(shapeAttributes) || py::isinstance<py::str>(shapeAttributes)) {
+		LOG_ERR << "shape attributes must be a list of dictionaries or a dictionary of attribute columns.";
+		return false;
+	}
+
+	const py::sequence shapesAttr = shapeAttributes.cast<py::sequence>();
+	if ((shapesAttr.size() != 1) &&
+	    (shapesAttr.size() < totalShapeCount)) { // if one shape attribute dictionary, same apply to all initial shapes.
+		LOG_ERR << "not enough shape attributes dictionaries defined.";
+		return false;
+	}
+	else if (shapesAttr.size() > totalShapeCount && firstShape == 0) {
+		LOG_WRN << "number of shape attributes dictionaries defined greater than number of initial shapes given."
+		        << std::endl;
+	}
+
+	ShapeAttributesConverter converter(attributeTypes);
+	convertedShapeAttr.resize(shapeCount);
+	for (size_t i = 0; i < shapeCount; i++) {
+		const size_t ind = firstShape + i;
+		convertedShapeAttr[i] = converter.convert(shapesAttr[(shapesAttr.size() > ind) ? ind : 0].cast<py::dict>());
+		if (!convertedShapeAttr[i])
+			return false;
+	}
+	return true;
+}
+
 // Chicken and egg situation for initial shapes from assets:
 // PRT requires to have any dependencies of the asset (e.g. textures) in the resolve map.
 // As we did not yet decode the asset, we do not know them.
@@ -79,6 +355,146 @@ ResolveMapPtr createResolveMapForInitialShape(const std::filesystem::path& asset
 	return resolveMap;
 }
 
+struct Shard {
+	size_t mFirst = 0;
+	size_t mCount = 0;
+	PyCallbacksPtr mCallbacks;
+	prt::Status mStatus = prt::STATUS_UNSPECIFIED_ERROR;
+};
+
+// the prototype IDs of every shard start at 0, the tables are merged into one table without duplicate meshes and the
+// instances are renumbered
+void mergePrototypeTables(const std::vector<Shard>& shards, std::vector<GeneratedPayloadPtr>& payloads) {
+	const size_t tableCount = std::count_if(shards.begin(), shards.end(), [](const Shard& shard) {
+		return !shard.mCallbacks->getPrototypes()->mPrototypes.empty();
+	});
+	if (tableCount <= 1)
+		return; // the payloads already share the only table
+
+	const PrototypeTablePtr mergedPrototypes = std::make_shared<PrototypeTable>();
+	for (const Shard& shard : shards) {
+		const PrototypeTablePtr& prototypes = shard.mCallbacks->getPrototypes();
+		if (prototypes->mPrototypes.empty())
+			continue;
+
+		std::vector<uint32_t> mergedIds;
+		mergedIds.reserve(prototypes->mPrototypes.size());
+		for (PrototypeTable::Prototype& prototype : prototypes->mPrototypes)
+			mergedIds.push_back(mergedPrototypes->add(std::move(prototype)));
+		*prototypes = PrototypeTable();
+
+		for (size_t i = 0; i < shard.mCount; i++) {
+			GeneratedPayload& payload = *payloads[shard.mFirst + i];
+			for (GeometryInstance& instance : payload.mInstances)
+				instance.mPrototypeId = mergedIds[instance.mPrototypeId];
+			if (!payload.mInstances.empty())
+				payload.mPrototypes = mergedPrototypes;
+		}
+	}
+}
+
+size_t getThreadCount(size_t numThreads) {
+	return (numThreads > 0) ? numThreads : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+/**
+ * Splits the initial shapes into shards and generates each shard with its own prt::generate call and callbacks
+ * object on the thread pool, or on the calling thread without a pool. The shards share the cache object, the
+ * payloads are merged back in initial shape order. Must be called without holding the GIL.
+ */
+prt::Status generateShards(const std::vector<const prt::InitialShape*>& initialShapes,
+                           const std::vector<const wchar_t*>& encoders,
+                           const std::vector<const prt::AttributeMap*>& encodersOptions,
+                           const AttributeKeyTableConstPtr& attributeKeys, prt::CacheObject* cache,
+                           ThreadPool* threadPool, size_t shardSize, std::vector<GeneratedPayloadPtr>& payloads) {
+	const size_t shapeCount = initialShapes.size();
+	const size_t threadCount = threadPool ? threadPool->getThreadCount() : 1;
+
+	if (shardSize == 0) {
+		const size_t shardCount = (threadCount > 1) ? threadCount * SHARDS_PER_THREAD : 1;
+		shardSize = (shapeCount + shardCount - 1) / shardCount;
+	}
+	shardSize = std::max<size_t>(shardSize, 1);
+
+	std::vector<Shard> shards;
+	shards.reserve((shapeCount + shardSize - 1) / shardSize);
+	for (size_t first = 0; first < shapeCount; first += shardSize) {
+		Shard& shard = shards.emplace_back();
+		shard.mFirst = first;
+		shard.mCount = std::min(shardSize, shapeCount - first);
+	}
+
+	auto generateShard = [&](Shard& shard) {
+		shard.mCallbacks = std::make_unique<PyCallbacks>(shard.mCount, attributeKeys);
+		shard.mStatus = prt::generate(initialShapes.data() + shard.mFirst, shard.mCount, nullptr, encoders.data(),
+		                              encoders.size(), encodersOptions.data(), shard.mCallbacks.get(), cache, nullptr);
+	};
+
+	if (threadCount == 1 || shards.size() <= 1) {
+		for (Shard& shard : shards)
+			generateShard(shard);
+	}
+	else {
+		LOG_DBG << "generating " << shapeCount << " initial shapes in " << shards.size() << " shards of size "
+		        << shardSize << " on " << threadCount << " threads";
+
+		// the pool may be shared with other generate calls, so only wait for the shards of this call
+		std::mutex shardsMutex;
+		std::condition_variable shardsDone;
+		size_t remainingShards = shards.size();
+		for (Shard& shard : shards) {
+			threadPool->submit([&]() {
+				try {
+					generateShard(shard);
+				}
+				catch (...) {
+					shard.mStatus = prt::STATUS_UNSPECIFIED_ERROR;
+				}
+				std::lock_guard<std::mutex> lock(shardsMutex);
+				if (--remainingShards == 0)
+					shardsDone.notify_one();
+			});
+		}
+		std::unique_lock<std::mutex> lock(shardsMutex);
+		shardsDone.wait(lock, [&remainingShards]() { return remainingShards == 0; });
+	}
+
+	payloads.resize(shapeCount);
+	for (const Shard& shard : shards) {
+		if (shard.mStatus != prt::STATUS_OK)
+			return shard.mStatus;
+		for (size_t i = 0; i < shard.mCount; i++)
+			payloads[shard.mFirst + i] = shard.mCallbacks->getGeneratedPayload(i);
+	}
+	mergePrototypeTables(shards, payloads);
+
+	return prt::STATUS_OK;
+}
+
+std::vector<GeneratedModel> createGeneratedModels(std::vector<GeneratedPayloadPtr>& payloads,
+                                                  size_t firstShapeIndex = 0) {
+	// the Python objects are created on first access, the payloads of the call share the attribute key objects
+	const auto attributeKeys = std::make_shared<PythonAttributeKeys>();
+	std::vector<GeneratedModel> models;
+	models.reserve(payloads.size());
+	for (size_t idx = 0; idx < payloads.size(); idx++) {
+		payloads[idx]->mPythonAttributeKeys = attributeKeys;
+		models.emplace_back(firstShapeIndex + idx, std::move(payloads[idx]));
+	}
+	return models;
+}
+
+// background threads for generate_model_async, only created on first use
+std::mutex theAsyncThreadPoolMutex;
+std::unique_ptr<ThreadPool> theAsyncThreadPool;
+
+void submitAsyncTask(ThreadPool::Task task) {
+	std::lock_guard<std::mutex> lock(theAsyncThreadPoolMutex);
+	if (!theAsyncThreadPool)
+		theAsyncThreadPool = std::make_unique<ThreadPool>(std::max<size_t>(std::thread::hardware_concurrency(), 1));
+	theAsyncThreadPool->submit(std::move(task));
+}
+
 } // namespace
 
 ModelGenerator::ModelGenerator(const std::vector<InitialShape>& protoShapes)
@@ -132,186 +548,388 @@ ModelGenerator::ModelGenerator(const std::vector<InitialShape>& protoShapes)
 	}
 }
 
-void ModelGenerator::setAndCreateInitialShape(const std::vector<py::dict>& shapesAttr,
-                                              std::vector<const prt::InitialShape*>& initShapes,
-                                              std::vector<InitialShapePtr>& initShapePtrs,
-                                              std::vector<AttributeMapPtr>& convertedShapeAttr) {
-	for (size_t ind = 0; ind < mInitialShapesBuilders.size(); ind++) {
-		py::dict shapeAttr = shapesAttr[0];
-		if (shapesAttr.size() > ind)
-			shapeAttr = shapesAttr[ind];
+/**
+ * Everything a generate call needs once the Python inputs are converted. The job owns all PRT objects it passes to
+ * PRT and can therefore be run without the GIL, also after the generate function has returned.
+ */
+struct ModelGenerator::GenerateJob {
+	RulePackagePtr mRulePackage;
+	std::vector<AttributeMapSPtr> mShapeAttributes; // shared by initial shapes with the same attributes
+	std::vector<InitialShapePtr> mInitialShapePtrs;
+	std::vector<const prt::InitialShape*> mInitialShapes;
+	std::vector<std::wstring> mEncoders;
+	std::vector<AttributeMapSPtr> mEncodersOptions; // shared with the EncoderOptionsCache
+	FileOutputCallbacksPtr mFileOutputCallbacks; // only set for encoders writing files
+	prt::CacheObject* mCache = nullptr;          // owned by the ModelGenerator
+	std::shared_ptr<ThreadPool> mThreadPool;     // shared with the ModelGenerator, null for a single thread
+	size_t mShardSize = 0;
+
+	prt::Status run(std::vector<GeneratedPayloadPtr>& payloads) const {
+		assert(mEncoders.size() == mEncodersOptions.size());
+		const std::vector<const wchar_t*> encoders = pcu::toPtrVec(mEncoders);
+		const std::vector<const prt::AttributeMap*> encodersOptions = pcu::toPtrVec(mEncodersOptions);
+
+		const prt::Status genStat =
+		        mFileOutputCallbacks
+		                ? prt::generate(mInitialShapes.data(), mInitialShapes.size(), nullptr, encoders.data(),
+		                                encoders.size(), encodersOptions.data(), mFileOutputCallbacks.get(), mCache,
+		                                nullptr)
+		                : generateShards(mInitialShapes, encoders, encodersOptions, mRulePackage->mAttributeKeys,
+		                                 mCache, mThreadPool.get(), mShardSize, payloads);
+
+		if (genStat != prt::STATUS_OK) {
+			LOG_ERR << "prt::generate() failed with status: '" << prt::getStatusDescription(genStat) << "' ("
+			        << genStat << ")";
+		}
+		return genStat;
+	}
+};
+
+bool ModelGenerator::setAndCreateInitialShape(const py::object& shapeAttributes, size_t firstShape, size_t shapeCount,
+                                              GenerateJob& job) {
+	if (!convertShapeAttributes(shapeAttributes, job.mRulePackage->mAttributeTypes, mInitialShapesBuilders.size(),
+	                            firstShape, shapeCount, job.mShapeAttributes))
+		return false;
+
+	job.mInitialShapes.resize(shapeCount);
+	job.mInitialShapePtrs.resize(shapeCount);
+
+	for (size_t i = 0; i < shapeCount; i++) {
+		const size_t ind = firstShape + i;
 
 		int32_t randomS = mSeed;
 		std::wstring shapeN = mShapeName;
-		extractMainShapeAttributes(shapeAttr, randomS, shapeN, convertedShapeAttr[ind]);
+		extractMainShapeAttributes(job.mShapeAttributes[i], randomS, shapeN);
 
-		mInitialShapesBuilders[ind]->setAttributes(mRuleFile.c_str(), mStartRule.c_str(), randomS, shapeN.c_str(),
-		                                           convertedShapeAttr[ind].get(), mResolveMap.get());
+		mInitialShapesBuilders[ind]->setAttributes(job.mRulePackage->mRuleFile.c_str(),
+		                                           job.mRulePackage->mStartRule.c_str(), randomS, shapeN.c_str(),
+		                                           job.mShapeAttributes[i].get(), job.mRulePackage->mResolveMap.get());
 
-		initShapePtrs[ind].reset(mInitialShapesBuilders[ind]->createInitialShape());
-		initShapes[ind] = initShapePtrs[ind].get();
+		job.mInitialShapePtrs[i].reset(mInitialShapesBuilders[ind]->createInitialShape());
+		job.mInitialShapes[i] = job.mInitialShapePtrs[i].get();
 	}
+	return true;
 }
 
-void ModelGenerator::initializeEncoderData(const std::wstring& encName, const py::dict& encOpt) {
-	mEncodersNames.clear();
-	mEncodersOptionsPtr.clear();
-
-	mEncodersNames.push_back(encName);
-	const AttributeMapPtr encOptions{pcu::createAttributeMapFromPythonDict(encOpt, *mEncoderBuilder)};
-	mEncodersOptionsPtr.push_back(pcu::createValidatedOptions(encName.c_str(), encOptions));
-
-	mEncodersNames.push_back(ENCODER_ID_CGA_REPORT);
-	mEncodersNames.push_back(ENCODER_ID_CGA_PRINT);
-	mEncodersNames.push_back(ENCODER_ID_CGA_ERROR);
-	mEncodersNames.push_back(ENCODER_ID_ATTR_EVAL);
-
-	const AttributeMapBuilderPtr optionsBuilder{prt::AttributeMapBuilder::create()};
-	const AttributeMapPtr reportOptions{optionsBuilder->createAttributeMapAndReset()};
-	const AttributeMapPtr printOptions{optionsBuilder->createAttributeMapAndReset()};
-	const AttributeMapPtr errorOptions{optionsBuilder->createAttributeMapAndReset()};
-	const AttributeMapPtr attrOptions{optionsBuilder->createAttributeMapAndReset()};
-
-	mEncodersOptionsPtr.push_back(pcu::createValidatedOptions(ENCODER_ID_CGA_REPORT, reportOptions));
-	mEncodersOptionsPtr.push_back(pcu::createValidatedOptions(ENCODER_ID_CGA_PRINT, printOptions));
-	mEncodersOptionsPtr.push_back(pcu::createValidatedOptions(ENCODER_ID_CGA_ERROR, errorOptions));
-	mEncodersOptionsPtr.push_back(pcu::createValidatedOptions(ENCODER_ID_ATTR_EVAL, attrOptions));
+void ModelGenerator::initializeEncoderData(const std::wstring& encName, const py::dict& encOpt,
+                                           uint32_t auxiliaryOutputs, GenerateJob& job) {
+	job.mEncoders.push_back(encName);
+	job.mEncodersOptions.push_back(getValidatedEncoderOptions(encName, encOpt, *mEncoderBuilder));
+
+	const py::dict noOptions;
+	for (const AuxiliaryEncoder& encoder : AUXILIARY_ENCODERS) {
+		if ((auxiliaryOutputs & encoder.mOutput) == 0)
+			continue;
+		job.mEncoders.push_back(encoder.mEncoderId);
+		job.mEncodersOptions.push_back(getValidatedEncoderOptions(encoder.mEncoderId, noOptions, *mEncoderBuilder));
+	}
 }
 
 prt::Status ModelGenerator::initializeRulePackageData(const std::filesystem::path& rulePackagePath,
-                                                      ResolveMapPtr& resolveMap, CachePtr& cache) {
+                                                      GenerateJob& job) {
 	if (!std::filesystem::exists(rulePackagePath)) {
 		LOG_ERR << "The rule package path is unvalid.";
 		return prt::STATUS_FILE_NOT_FOUND;
 	}
 
-	if (!pcu::getResolveMap(rulePackagePath, &resolveMap))
-		return prt::STATUS_RESOLVEMAP_PROVIDER_NOT_FOUND;
-
-	mRuleFile = pcu::getRuleFileEntry(resolveMap.get());
-
-	const wchar_t* ruleFileURI = resolveMap->getString(mRuleFile.c_str());
-	if (ruleFileURI == nullptr) {
-		LOG_ERR << "could not find rule file URI in resolve map of rule package " << rulePackagePath;
-		return prt::STATUS_INVALID_URI;
-	}
-
-	prt::Status infoStatus = prt::STATUS_UNSPECIFIED_ERROR;
-	RuleFileInfoUPtr info(prt::createRuleFileInfo(ruleFileURI, cache.get(), &infoStatus));
-	if (!info || infoStatus != prt::STATUS_OK) {
-		LOG_ERR << "could not get rule file info from rule file " << mRuleFile;
-		return infoStatus;
-	}
+	prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
+	job.mRulePackage = RulePackageRegistry::instance().get(rulePackagePath, mCache.get(), status);
+	return status;
+}
 
-	mStartRule = pcu::detectStartRule(info);
-	mHiddenAttrs = pcu::getHiddenAttributes(info);
-	return prt::STATUS_OK;
+/**
+ * The threads of the pool are reused by all generate calls of this ModelGenerator. A call with a different thread
+ * count replaces the pool, the jobs still running keep the previous pool alive.
+ */
+std::shared_ptr<ThreadPool> ModelGenerator::getThreadPool(size_t threadCount) {
+	if (threadCount <= 1)
+		return {};
+	if (!mThreadPool || mThreadPool->getThreadCount() != threadCount)
+		mThreadPool = std::make_shared<ThreadPool>(threadCount);
+	return mThreadPool;
 }
 
-std::vector<GeneratedModel> ModelGenerator::generateModel(const std::vector<py::dict>& shapeAttributes,
-                                                          const std::filesystem::path& rulePackagePath,
-                                                          const std::wstring& geometryEncoderName,
-                                                          const py::dict& geometryEncoderOptions) {
+ModelGenerator::GenerateJobPtr ModelGenerator::prepareGenerateJob(const py::object& shapeAttributes,
+                                                                  const std::filesystem::path& rulePackagePath,
+                                                                  const std::wstring& geometryEncoderName,
+                                                                  const py::dict& geometryEncoderOptions,
+                                                                  size_t numThreads, size_t shardSize,
+                                                                  const py::object& auxiliaryOutputs,
+                                                                  size_t firstShape, size_t shapeCount) {
 	if (!mValid) {
 		LOG_ERR << "invalid ModelGenerator instance.";
 		return {};
 	}
 
-	if ((shapeAttributes.size() != 1) &&
-	    (shapeAttributes.size() <
-	     mInitialShapesBuilders.size())) { // if one shape attribute dictionary, same apply to all initial shapes.
-		LOG_ERR << "not enough shape attributes dictionaries defined.";
+	uint32_t auxiliaryOutputFlags = AUX_OUTPUT_ALL;
+	if (!getAuxiliaryOutputs(auxiliaryOutputs, auxiliaryOutputFlags))
 		return {};
-	}
-	else if (shapeAttributes.size() > mInitialShapesBuilders.size()) {
-		LOG_WRN << "number of shape attributes dictionaries defined greater than number of initial shapes given."
-		        << std::endl;
-	}
 
-	try {
-		// Rule package
-		prt::Status rpkStat = initializeRulePackageData(rulePackagePath, mResolveMap, mCache);
-
-		if (rpkStat != prt::STATUS_OK)
-			return {};
+	auto job = std::make_shared<GenerateJob>();
+	job->mCache = mCache.get();
+	job->mShardSize = shardSize;
 
-		// Initial shapes
-		std::vector<const prt::InitialShape*> initialShapes(mInitialShapesBuilders.size());
-		std::vector<InitialShapePtr> initialShapePtrs(mInitialShapesBuilders.size());
-		std::vector<AttributeMapPtr> convertedShapeAttrVec(mInitialShapesBuilders.size());
-		setAndCreateInitialShape(shapeAttributes, initialShapes, initialShapePtrs, convertedShapeAttrVec);
+	// Rule package
+	prt::Status rpkStat = initializeRulePackageData(rulePackagePath, *job);
 
-		// Encoder info, encoder options
-		if (!mEncoderBuilder)
-			mEncoderBuilder.reset(prt::AttributeMapBuilder::create());
+	if (rpkStat != prt::STATUS_OK)
+		return {};
 
-		initializeEncoderData(geometryEncoderName, geometryEncoderOptions);
+	// Initial shapes
+	if (!setAndCreateInitialShape(shapeAttributes, firstShape,
+	                              std::min(shapeCount, mInitialShapesBuilders.size() - firstShape), *job))
+		return {};
 
-		assert(mEncodersNames.size() == mEncodersOptionsPtr.size());
-		const std::vector<const wchar_t*> encoders = pcu::toPtrVec(mEncodersNames);
-		const std::vector<const prt::AttributeMap*> encodersOptions = pcu::toPtrVec(mEncodersOptionsPtr);
-		assert(encoders.size() == encodersOptions.size());
+	// Encoder info, encoder options
+	if (!mEncoderBuilder)
+		mEncoderBuilder.reset(prt::AttributeMapBuilder::create());
 
-		if (geometryEncoderName == ENCODER_ID_PYTHON) {
+	initializeEncoderData(geometryEncoderName, geometryEncoderOptions, auxiliaryOutputFlags, *job);
 
-			PyCallbacksPtr foc{std::make_unique<PyCallbacks>(mInitialShapesBuilders.size(), mHiddenAttrs)};
+	if (geometryEncoderName == ENCODER_ID_PYTHON)
+		job->mThreadPool = getThreadPool(getThreadCount(numThreads));
 
-			// Generate
-			const prt::Status genStat =
-			        prt::generate(initialShapes.data(), initialShapes.size(), nullptr, encoders.data(), encoders.size(),
-			                      encodersOptions.data(), foc.get(), mCache.get(), nullptr);
+	if (geometryEncoderName != ENCODER_ID_PYTHON) {
+		if (numThreads != 1 || shardSize != 0)
+			LOG_WRN << "sharded generation is only supported by the PyEncoder, generating all initial shapes at once.";
 
-			if (genStat != prt::STATUS_OK) {
-				LOG_ERR << "prt::generate() failed with status: '" << prt::getStatusDescription(genStat) << "' ("
-				        << genStat << ")";
-				return {};
+		const std::filesystem::path outputPath = [&geometryEncoderOptions]() {
+			if (geometryEncoderOptions.contains(ENC_OPT_OUTPUT_PATH)) {
+				return std::filesystem::path(geometryEncoderOptions[ENC_OPT_OUTPUT_PATH].cast<std::string>());
 			}
-
-			std::vector<GeneratedModel> newGeneratedGeo;
-			newGeneratedGeo.reserve(mInitialShapesBuilders.size());
-			for (size_t idx = 0; idx < mInitialShapesBuilders.size(); idx++) {
-				newGeneratedGeo.emplace_back(idx, foc->getGeneratedPayload(idx));
+			else {
+				const auto fallbackOutputPath = std::filesystem::temp_directory_path() / "pyprt_fallback_output";
+				std::filesystem::create_directory(fallbackOutputPath);
+				LOG_WRN << "Encoder option '" << ENC_OPT_OUTPUT_PATH
+				        << "' was not specified, falling back to system tmp directory:" << fallbackOutputPath;
+				return fallbackOutputPath;
 			}
-			return newGeneratedGeo;
+		}();
+		LOG_DBG << "got outputPath = " << outputPath;
+
+		if (std::filesystem::is_directory(outputPath) && std::filesystem::exists(outputPath)) {
+			job->mFileOutputCallbacks.reset(prt::FileOutputCallbacks::create(outputPath.wstring().c_str()));
 		}
 		else {
-			const std::filesystem::path outputPath = [&geometryEncoderOptions]() {
-				if (geometryEncoderOptions.contains(ENC_OPT_OUTPUT_PATH)) {
-					return std::filesystem::path(geometryEncoderOptions[ENC_OPT_OUTPUT_PATH].cast<std::string>());
-				}
-				else {
-					const auto fallbackOutputPath = std::filesystem::temp_directory_path() / "pyprt_fallback_output";
-					std::filesystem::create_directory(fallbackOutputPath);
-					LOG_WRN << "Encoder option '" << ENC_OPT_OUTPUT_PATH
-					        << "' was not specified, falling back to system tmp directory:" << fallbackOutputPath;
-					return fallbackOutputPath;
-				}
-			}();
-			LOG_DBG << "got outputPath = " << outputPath;
+			LOG_ERR << "The directory specified by '" << ENC_OPT_OUTPUT_PATH
+			        << "' is not valid or does not exist: " << outputPath << std::endl;
+			return {};
+		}
+	}
 
-			FileOutputCallbacksPtr foc;
-			if (std::filesystem::is_directory(outputPath) && std::filesystem::exists(outputPath)) {
-				foc.reset(prt::FileOutputCallbacks::create(outputPath.wstring().c_str()));
-			}
-			else {
-				LOG_ERR << "The directory specified by '" << ENC_OPT_OUTPUT_PATH
-				        << "' is not valid or does not exist: " << outputPath << std::endl;
-				return {};
+	return job;
+}
+
+std::vector<GeneratedModel> ModelGenerator::generateModel(const py::object& shapeAttributes,
+                                                          const std::filesystem::path& rulePackagePath,
+                                                          const std::wstring& geometryEncoderName,
+                                                          const py::dict& geometryEncoderOptions, size_t numThreads,
+                                                          size_t shardSize, const py::object& auxiliaryOutputs) {
+	try {
+		const GenerateJobPtr job =
+		        prepareGenerateJob(shapeAttributes, rulePackagePath, geometryEncoderName, geometryEncoderOptions,
+		                           numThreads, shardSize, auxiliaryOutputs, 0, mInitialShapesBuilders.size());
+		if (!job)
+			return {};
+
+		// Generate, the callbacks do not touch any Python objects
+		std::vector<GeneratedPayloadPtr> payloads;
+		const prt::Status genStat = [&]() {
+			py::gil_scoped_release release;
+			return job->run(payloads);
+		}();
+		PythonLogHandler::flushPendingMessages();
+
+		if (genStat != prt::STATUS_OK)
+			return {};
+
+		return createGeneratedModels(payloads);
+	}
+	catch (const std::exception& e) {
+		LOG_ERR << "caught exception: " << e.what();
+	}
+	catch (...) {
+		LOG_ERR << "caught unknown exception.";
+	}
+
+	return {};
+}
+
+GeneratedBatchPtr ModelGenerator::generateBatch(const py::object& shapeAttributes,
+                                                const std::filesystem::path& rulePackagePath,
+                                                const py::dict& geometryEncoderOptions, size_t numThreads,
+                                                size_t shardSize, const py::object& auxiliaryOutputs) {
+	try {
+		const GenerateJobPtr job =
+		        prepareGenerateJob(shapeAttributes, rulePackagePath, ENCODER_ID_PYTHON, geometryEncoderOptions,
+		                           numThreads, shardSize, auxiliaryOutputs, 0, mInitialShapesBuilders.size());
+		if (!job)
+			return std::make_shared<GeneratedBatch>();
+
+		const prt::AttributeMap* options = job->mEncodersOptions.front().get();
+		for (const wchar_t* option : BATCH_UNSUPPORTED_OPTIONS) {
+			if (options->hasKey(option) && options->getType(option) == prt::AttributeMap::PT_BOOL &&
+			    options->getBool(option)) {
+				LOG_ERR << L"the encoder option '" << option << L"' is not supported by generate_batch.";
+				return std::make_shared<GeneratedBatch>();
 			}
+		}
 
-			// Generate
-			const prt::Status genStat =
-			        prt::generate(initialShapes.data(), initialShapes.size(), nullptr, encoders.data(), encoders.size(),
-			                      encodersOptions.data(), foc.get(), mCache.get(), nullptr);
+		std::vector<GeneratedPayloadPtr> payloads;
+		GeneratedBatchPtr batch = [&]() {
+			py::gil_scoped_release release;
+			if (job->run(payloads) != prt::STATUS_OK)
+				return std::make_shared<GeneratedBatch>();
+			return std::make_shared<GeneratedBatch>(std::move(payloads), job->mShapeAttributes);
+		}();
+		PythonLogHandler::flushPendingMessages();
+		return batch;
+	}
+	catch (const std::exception& e) {
+		LOG_ERR << "caught exception: " << e.what();
+	}
+	catch (...) {
+		LOG_ERR << "caught unknown exception.";
+	}
 
-			if (genStat != prt::STATUS_OK) {
-				LOG_ERR << "prt::generate() failed with status: '" << prt::getStatusDescription(genStat) << "' ("
-				        << genStat << ")";
-				return {};
+	return std::make_shared<GeneratedBatch>();
+}
+
+py::object ModelGenerator::generateModelAsync(const py::object& shapeAttributes,
+                                              const std::filesystem::path& rulePackagePath,
+                                              const std::wstring& geometryEncoderName,
+                                              const py::dict& geometryEncoderOptions, size_t numThreads,
+                                              size_t shardSize, const py::object& auxiliaryOutputs) {
+	py::object future = py::module_::import("concurrent.futures").attr("Future")();
+
+	GenerateJobPtr job;
+	try {
+		job = prepareGenerateJob(shapeAttributes, rulePackagePath, geometryEncoderName, geometryEncoderOptions,
+		                         numThreads, shardSize, auxiliaryOutputs, 0, mInitialShapesBuilders.size());
+	}
+	catch (const std::exception& e) {
+		LOG_ERR << "caught exception: " << e.what();
+	}
+	catch (...) {
+		LOG_ERR << "caught unknown exception.";
+	}
+
+	if (!job) {
+		future.attr("set_running_or_notify_cancel")();
+		future.attr("set_result")(std::vector<GeneratedModel>());
+		return future;
+	}
+
+	// the task holds a reference to this generator, its cache is used by the job
+	submitAsyncTask([job = std::move(job), future, generator = py::cast(this)]() mutable {
+		// Python references must only be released with the GIL held, not when the task is destroyed
+		auto releasePythonObjects = [&]() {
+			job.reset();
+			future = py::object();
+			generator = py::object();
+		};
+
+		{
+			py::gil_scoped_acquire acquire;
+			if (!future.attr("set_running_or_notify_cancel")().cast<bool>()) {
+				releasePythonObjects();
+				return;
 			}
+		}
 
-			return {};
+		std::vector<GeneratedPayloadPtr> payloads;
+		prt::Status genStat = prt::STATUS_UNSPECIFIED_ERROR;
+		try {
+			genStat = job->run(payloads);
 		}
+		catch (const std::exception& e) {
+			LOG_ERR << "caught exception: " << e.what();
+		}
+		catch (...) {
+			LOG_ERR << "caught unknown exception.";
+		}
+
+		py::gil_scoped_acquire acquire;
+		try {
+			PythonLogHandler::flushPendingMessages();
+			std::vector<GeneratedModel> models;
+			if (genStat == prt::STATUS_OK)
+				models = createGeneratedModels(payloads);
+			future.attr("set_result")(std::move(models));
+		}
+		catch (const std::exception& e) {
+			LOG_ERR << "caught exception: " << e.what();
+		}
+		payloads.clear();
+		releasePythonObjects();
+	});
+
+	return future;
+}
+
+void ModelGenerator::shutdownAsyncGeneration() {
+	std::unique_ptr<ThreadPool> threadPool;
+	{
+		std::lock_guard<std::mutex> lock(theAsyncThreadPoolMutex);
+		threadPool = std::move(theAsyncThreadPool);
+	}
+	threadPool.reset(); // runs the remaining tasks and joins the threads
+}
+
+std::unique_ptr<GeneratedModelIterator> ModelGenerator::generateIter(const py::object& shapeAttributes,
+                                                                     const std::filesystem::path& rulePackagePath,
+                                                                     const std::wstring& geometryEncoderName,
+                                                                     const py::dict& geometryEncoderOptions,
+                                                                     size_t chunkSize, size_t numThreads,
+                                                                     size_t shardSize,
+                                                                     const py::object& auxiliaryOutputs) {
+	return std::make_unique<GeneratedModelIterator>(*this, py::cast(this), shapeAttributes, rulePackagePath,
+	                                                geometryEncoderName, geometryEncoderOptions, chunkSize, numThreads,
+	                                                shardSize, auxiliaryOutputs);
+}
+
+struct GeneratedModelIterator::Chunk {
+	size_t mFirstShape = 0;
+	ModelGenerator::GenerateJobPtr mJob;
+	std::vector<GeneratedPayloadPtr> mPayloads;
+	std::promise<prt::Status> mPromise;
+	std::future<prt::Status> mStatus = mPromise.get_future();
+};
+
+GeneratedModelIterator::GeneratedModelIterator(ModelGenerator& generator, py::object generatorRef,
+                                               const py::object& shapeAttributes,
+                                               const std::filesystem::path& rulePackagePath,
+                                               const std::wstring& geometryEncoderName,
+                                               const py::dict& geometryEncoderOptions, size_t chunkSize,
+                                               size_t numThreads, size_t shardSize,
+                                               const py::object& auxiliaryOutputs)
+    : mGenerator(generator), mGeneratorRef(std::move(generatorRef)), mShapeAttributes(shapeAttributes),
+      mRulePackagePath(rulePackagePath), mGeometryEncoderName(geometryEncoderName),
+      mGeometryEncoderOptions(geometryEncoderOptions),
+      mChunkSize((chunkSize > 0) ? chunkSize : generator.mInitialShapesBuilders.size()), mNumThreads(numThreads),
+      mShardSize(shardSize), mAuxiliaryOutputs(auxiliaryOutputs) {
+	startNextChunk();
+}
+
+GeneratedModelIterator::~GeneratedModelIterator() {
+	// the pending chunk uses the cache of the generator, it has to finish before the generator can go away
+	if (mPendingChunk) {
+		py::gil_scoped_release release;
+		mPendingChunk->mStatus.wait();
+	}
+}
+
+void GeneratedModelIterator::startNextChunk() {
+	const size_t shapeCount = mGenerator.mInitialShapesBuilders.size();
+	if (mNextShape >= shapeCount)
+		return;
+
+	auto chunk = std::make_shared<Chunk>();
+	chunk->mFirstShape = mNextShape;
+	try {
+		chunk->mJob = mGenerator.prepareGenerateJob(mShapeAttributes, mRulePackagePath, mGeometryEncoderName,
+		                                            mGeometryEncoderOptions, mNumThreads, mShardSize,
+		                                            mAuxiliaryOutputs, mNextShape, mChunkSize);
 	}
 	catch (const std::exception& e) {
 		LOG_ERR << "caught exception: " << e.what();
@@ -320,5 +938,47 @@ std::vector<GeneratedModel> ModelGenerator::generateModel(const std::vector<py::
 		LOG_ERR << "caught unknown exception.";
 	}
 
-	return {};
-}
\ No newline at end of file
+	if (!chunk->mJob) {
+		mNextShape = shapeCount; // no point in trying the remaining chunks
+		return;
+	}
+
+	mNextShape += chunk->mJob->mInitialShapes.size();
+	mPendingChunk = chunk;
+
+	submitAsyncTask([chunk]() {
+		prt::Status genStat = prt::STATUS_UNSPECIFIED_ERROR;
+		try {
+			genStat = chunk->mJob->run(chunk->mPayloads);
+		}
+		catch (const std::exception& e) {
+			LOG_ERR << "caught exception: " << e.what();
+		}
+		catch (...) {
+			LOG_ERR << "caught unknown exception.";
+		}
+		chunk->mPromise.set_value(genStat);
+	});
+}
+
+std::vector<GeneratedModel> GeneratedModelIterator::next() {
+	if (!mPendingChunk)
+		throw py::stop_iteration();
+
+	const std::shared_ptr<Chunk> chunk = std::move(mPendingChunk);
+	const prt::Status genStat = [&chunk]() {
+		py::gil_scoped_release release;
+		return chunk->mStatus.get();
+	}();
+	PythonLogHandler::flushPendingMessages();
+
+	if (genStat != prt::STATUS_OK) {
+		mNextShape = mGenerator.mInitialShapesBuilders.size();
+		throw py::stop_iteration();
+	}
+
+	// the next chunk is generated while the caller processes this one
+	startNextChunk();
+
+	return createGeneratedModels(chunk->mPayloads, chunk->mFirstShape);
+}
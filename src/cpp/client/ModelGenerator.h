@@ -19,48 +19,124 @@
 
 #pragma once
 
+#include "GeneratedBatch.h"
 #include "GeneratedModel.h"
 #include "InitialShape.h"
+#include "RulePackageRegistry.h"
 #include "types.h"
 #include "utils.h"
 
 #include "pybind11/pybind11.h"
 
 #include <filesystem>
+#include <memory>
 #include <vector>
 
+class GeneratedModelIterator;
+class ThreadPool;
+
 class ModelGenerator {
 public:
 	explicit ModelGenerator(const std::vector<InitialShape>& protoShapes);
 	~ModelGenerator() = default;
 
-	std::vector<GeneratedModel> generateModel(const std::vector<pybind11::dict>& shapeAttributes,
+	std::vector<GeneratedModel> generateModel(const pybind11::object& shapeAttributes,
 	                                          const std::filesystem::path& rulePackagePath,
 	                                          const std::wstring& geometryEncoderName,
-	                                          const pybind11::dict& geometryEcoderOptions);
+	                                          const pybind11::dict& geometryEcoderOptions, size_t numThreads = 1,
+	                                          size_t shardSize = 0,
+	                                          const pybind11::object& auxiliaryOutputs = pybind11::none());
+
+	// geometry, reports and rule attributes of all models in concatenated buffers, PyEncoder only
+	GeneratedBatchPtr generateBatch(const pybind11::object& shapeAttributes,
+	                                const std::filesystem::path& rulePackagePath,
+	                                const pybind11::dict& geometryEncoderOptions, size_t numThreads = 1,
+	                                size_t shardSize = 0, const pybind11::object& auxiliaryOutputs = pybind11::none());
+
+	// returns a concurrent.futures.Future which resolves to the generated models
+	pybind11::object generateModelAsync(const pybind11::object& shapeAttributes,
+	                                    const std::filesystem::path& rulePackagePath,
+	                                    const std::wstring& geometryEncoderName,
+	                                    const pybind11::dict& geometryEcoderOptions, size_t numThreads = 1,
+	                                    size_t shardSize = 0,
+	                                    const pybind11::object& auxiliaryOutputs = pybind11::none());
+
+	std::unique_ptr<GeneratedModelIterator> generateIter(const pybind11::object& shapeAttributes,
+	                                                     const std::filesystem::path& rulePackagePath,
+	                                                     const std::wstring& geometryEncoderName,
+	                                                     const pybind11::dict& geometryEcoderOptions,
+	                                                     size_t chunkSize, size_t numThreads = 1,
+	                                                     size_t shardSize = 0,
+	                                                     const pybind11::object& auxiliaryOutputs = pybind11::none());
+
+	// waits for the pending asynchronous generate calls and stops their threads, must be called without the GIL
+	static void shutdownAsyncGeneration();
 
 private:
-	ResolveMapPtr mResolveMap;
+	friend class GeneratedModelIterator;
+
+	struct GenerateJob;
+	using GenerateJobPtr = std::shared_ptr<GenerateJob>;
+
 	CachePtr mCache;
 
 	AttributeMapBuilderPtr mEncoderBuilder;
-	std::vector<AttributeMapPtr> mEncodersOptionsPtr;
-	std::vector<std::wstring> mEncodersNames;
 	std::vector<InitialShapeBuilderPtr> mInitialShapesBuilders;
 
-	std::wstring mRuleFile;
-	std::wstring mStartRule;
-	std::unordered_set<std::wstring> mHiddenAttrs;
 	int32_t mSeed = 0;
 	std::wstring mShapeName = L"InitialShape";
 
 	bool mValid = true;
 
-	void setAndCreateInitialShape(const std::vector<pybind11::dict>& shapeAttr,
-	                              std::vector<const prt::InitialShape*>& initShapes,
-	                              std::vector<InitialShapePtr>& initShapesPtrs,
-	                              std::vector<AttributeMapPtr>& convertShapeAttr);
-	void initializeEncoderData(const std::wstring& encName, const pybind11::dict& encOpt);
-	prt::Status initializeRulePackageData(const std::filesystem::path& rulePackagePath, ResolveMapPtr& resolveMap,
-	                                      CachePtr& cache);
+	std::shared_ptr<ThreadPool> mThreadPool; // only accessed with the GIL held
+
+	std::shared_ptr<ThreadPool> getThreadPool(size_t threadCount);
+	GenerateJobPtr prepareGenerateJob(const pybind11::object& shapeAttributes,
+	                                  const std::filesystem::path& rulePackagePath,
+	                                  const std::wstring& geometryEncoderName,
+	                                  const pybind11::dict& geometryEncoderOptions, size_t numThreads,
+	                                  size_t shardSize, const pybind11::object& auxiliaryOutputs, size_t firstShape,
+	                                  size_t shapeCount);
+	bool setAndCreateInitialShape(const pybind11::object& shapeAttributes, size_t firstShape, size_t shapeCount,
+	                              GenerateJob& job);
+	void initializeEncoderData(const std::wstring& encName, const pybind11::dict& encOpt, uint32_t auxiliaryOutputs,
+	                           GenerateJob& job);
+	prt::Status initializeRulePackageData(const std::filesystem::path& rulePackagePath, GenerateJob& job);
+};
+
+/**
+ * Generates the models of a ModelGenerator chunk by chunk. While a chunk is returned to Python, the next one is already
+ * generated in the background, so at most two chunks of generated models are held by the iterator at once.
+ */
+class GeneratedModelIterator {
+public:
+	GeneratedModelIterator(ModelGenerator& generator, pybind11::object generatorRef,
+	                       const pybind11::object& shapeAttributes,
+	                       const std::filesystem::path& rulePackagePath, const std::wstring& geometryEncoderName,
+	                       const pybind11::dict& geometryEncoderOptions, size_t chunkSize, size_t numThreads,
+	                       size_t shardSize, const pybind11::object& auxiliaryOutputs);
+	GeneratedModelIterator(const GeneratedModelIterator&) = delete;
+	GeneratedModelIterator& operator=(const GeneratedModelIterator&) = delete;
+	~GeneratedModelIterator();
+
+	std::vector<GeneratedModel> next();
+
+private:
+	struct Chunk;
+
+	void startNextChunk();
+
+	ModelGenerator& mGenerator;
+	pybind11::object mGeneratorRef; // keeps the generator alive
+	pybind11::object mShapeAttributes;
+	std::filesystem::path mRulePackagePath;
+	std::wstring mGeometryEncoderName;
+	pybind11::dict mGeometryEncoderOptions;
+	size_t mChunkSize;
+	size_t mNumThreads;
+	size_t mShardSize;
+	pybind11::object mAuxiliaryOutputs;
+
+	size_t mNextShape = 0;
+	std::shared_ptr<Chunk> mPendingChunk;
 };
@@ -19,9 +19,24 @@
 
 #include "PyCallbacks.h"
 
-PyCallbacks::PyCallbacks(const size_t initialShapeCount, const std::unordered_set<std::wstring>& hiddenAttrs) {
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+void appendRebasedIndices(Indices& indices, const std::vector<uint32_t>& newIndices, uint32_t vertexIndexBase) {
+	const size_t firstIndex = indices.size();
+	indices.resize(firstIndex + newIndices.size());
+	std::transform(newIndices.begin(), newIndices.end(), indices.begin() + firstIndex,
+	               [vertexIndexBase](uint32_t index) { return index + vertexIndexBase; });
+}
+
+} // namespace
+
+PyCallbacks::PyCallbacks(const size_t initialShapeCount, const AttributeKeyTableConstPtr& ruleAttributeKeys)
+    : mAttributeKeys(std::make_shared<AttributeKeyTable>(ruleAttributeKeys)),
+      mPrototypes(std::make_shared<PrototypeTable>()) {
 	mPayloads.resize(initialShapeCount);
-	mHiddenAttrs = hiddenAttrs;
 }
 
 prt::Status PyCallbacks::generateError(size_t /*isIndex*/, prt::Status /*status*/, const wchar_t* /*message*/) {
@@ -75,84 +90,137 @@ prt::Status PyCallbacks::attrFloat(size_t isIndex, int32_t /*shapeID*/, const wc
 }
 
 prt::Status PyCallbacks::attrString(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key, const wchar_t* value) {
-	return storeAttr(isIndex, key, value);
+	return storeAttr(isIndex, key, std::wstring(value));
 }
 
 prt::Status PyCallbacks::attrBoolArray(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key, const bool* ptr,
                                        size_t size, size_t nRows) {
-	return storeAttr(isIndex, key, ptr, size, nRows);
+	return storeAttr<uint8_t>(isIndex, key, ptr, size, nRows);
 }
 
 prt::Status PyCallbacks::attrFloatArray(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key, const double* ptr,
                                         size_t size, size_t nRows) {
-	return storeAttr(isIndex, key, ptr, size, nRows);
+	return storeAttr<double>(isIndex, key, ptr, size, nRows);
 }
 
 prt::Status PyCallbacks::attrStringArray(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key,
                                          const wchar_t* const* ptr, size_t size, size_t nRows) {
-	return storeAttr(isIndex, key, ptr, size, nRows);
+	return storeAttr<std::wstring>(isIndex, key, ptr, size, nRows);
 }
 
-void PyCallbacks::addGeometry(const size_t initialShapeIndex, const double* vertexCoords,
-                              const size_t vertexCoordsCount, const uint32_t* faceIndices,
-                              const size_t faceIndicesCount, const uint32_t* faceCounts, const size_t faceCountsCount) {
+void PyCallbacks::addGeometry(const size_t initialShapeIndex, std::vector<double>&& vertexCoords,
+                              std::vector<uint32_t>&& faceIndices, std::vector<uint32_t>&& faceCounts) {
+	GeneratedPayload& currentModel = getOrCreate(initialShapeIndex);
+
+	// the geometry of an initial shape usually arrives at once and the buffers are taken over
+	if (currentModel.mVertices.empty() && currentModel.mIndices.empty() && currentModel.mFaces.empty()) {
+		currentModel.mVertices = std::move(vertexCoords);
+		currentModel.mIndices = std::move(faceIndices);
+		currentModel.mFaces = std::move(faceCounts);
+		return;
+	}
+
+	const uint32_t vertexIndexBase = static_cast<uint32_t>(currentModel.mVertices.size() / 3);
+	currentModel.mVertices.insert(currentModel.mVertices.end(), vertexCoords.begin(), vertexCoords.end());
+	appendRebasedIndices(currentModel.mIndices, faceIndices, vertexIndexBase);
+	currentModel.mFaces.insert(currentModel.mFaces.end(), faceCounts.begin(), faceCounts.end());
+}
 
+void PyCallbacks::addLocalGeometry(const size_t initialShapeIndex, const double* origin,
+                                   std::vector<float>&& vertexCoords, std::vector<uint32_t>&& faceIndices,
+                                   std::vector<uint32_t>&& faceCounts) {
 	GeneratedPayload& currentModel = getOrCreate(initialShapeIndex);
 
-	if (vertexCoords != nullptr)
-		currentModel.mVertices.insert(currentModel.mVertices.end(), vertexCoords, vertexCoords + vertexCoordsCount);
+	if (currentModel.mLocalVertices.empty() && currentModel.mIndices.empty() && currentModel.mFaces.empty()) {
+		std::copy(origin, origin + 3, currentModel.mOrigin.begin());
+		currentModel.mLocalVertices = std::move(vertexCoords);
+		currentModel.mIndices = std::move(faceIndices);
+		currentModel.mFaces = std::move(faceCounts);
+		return;
+	}
+
+	// further geometry is moved to the origin of the payload
+	const uint32_t vertexIndexBase = static_cast<uint32_t>(currentModel.mLocalVertices.size() / 3);
+	const size_t firstCoord = currentModel.mLocalVertices.size();
+	currentModel.mLocalVertices.resize(firstCoord + vertexCoords.size());
+	for (size_t i = 0; i < vertexCoords.size(); i++) {
+		const double shift = origin[i % 3] - currentModel.mOrigin[i % 3];
+		currentModel.mLocalVertices[firstCoord + i] = static_cast<float>(vertexCoords[i] + shift);
+	}
+	appendRebasedIndices(currentModel.mIndices, faceIndices, vertexIndexBase);
+	currentModel.mFaces.insert(currentModel.mFaces.end(), faceCounts.begin(), faceCounts.end());
+}
+
+void PyCallbacks::addCompactGeometry(const size_t initialShapeIndex, std::vector<uint8_t>&& buffer) {
+	// the geometry of an initial shape arrives at once, a further buffer would replace it
+	getOrCreate(initialShapeIndex).mCompactGeometry = std::move(buffer);
+}
+
+void PyCallbacks::addSummary(const size_t initialShapeIndex, const GeometrySummary& summary) {
+	getOrCreate(initialShapeIndex).mSummary = summary;
+}
+
+void PyCallbacks::addFaceShapeIds(const size_t initialShapeIndex, std::vector<uint32_t>&& faceShapeIds,
+                                  std::vector<std::wstring>&& shapeNames) {
+	auto& currentModel = getOrCreate(initialShapeIndex);
+	if (currentModel.mShapeNames.empty()) {
+		currentModel.mFaceShapeIds = std::move(faceShapeIds);
+		currentModel.mShapeNames = std::move(shapeNames);
+		return;
+	}
+
+	// the IDs of further faces refer to the appended shape names
+	appendRebasedIndices(currentModel.mFaceShapeIds, faceShapeIds,
+	                     static_cast<uint32_t>(currentModel.mShapeNames.size()));
+	currentModel.mShapeNames.insert(currentModel.mShapeNames.end(), std::make_move_iterator(shapeNames.begin()),
+	                                std::make_move_iterator(shapeNames.end()));
+}
 
-	if (faceIndices != nullptr)
-		currentModel.mIndices.insert(currentModel.mIndices.end(), faceIndices, faceIndices + faceIndicesCount);
+uint32_t PyCallbacks::addPrototype(std::vector<double>&& vertexCoords, std::vector<uint32_t>&& faceIndices,
+                                   std::vector<uint32_t>&& faceCounts) {
+	std::lock_guard<std::mutex> lock(mPrototypeMutex);
+	return mPrototypes->add({std::move(vertexCoords), std::move(faceIndices), std::move(faceCounts)});
+}
 
-	if (faceCounts != nullptr)
-		currentModel.mFaces.insert(currentModel.mFaces.end(), faceCounts, faceCounts + faceCountsCount);
+void PyCallbacks::addInstance(const size_t initialShapeIndex, const uint32_t prototypeId,
+                              const double* transformation) {
+	GeometryInstance& instance = getOrCreate(initialShapeIndex).mInstances.emplace_back();
+	instance.mPrototypeId = prototypeId;
+	std::copy(transformation, transformation + instance.mTransformation.size(), instance.mTransformation.begin());
 }
 
 void PyCallbacks::addReports(const size_t initialShapeIndex, const wchar_t** stringReportKeys,
                              const wchar_t** stringReportValues, size_t stringReportCount,
                              const wchar_t** floatReportKeys, const double* floatReportValues, size_t floatReportCount,
                              const wchar_t** boolReportKeys, const bool* boolReportValues, size_t boolReportCount) {
-	namespace py = pybind11;
-
 	GeneratedPayload& currentModel = getOrCreate(initialShapeIndex);
+	currentModel.mReports.reserve(currentModel.mReports.size() + boolReportCount + floatReportCount +
+	                              stringReportCount);
 
-	for (size_t i = 0; i < boolReportCount; i++) {
-		py::object pyKey = py::cast(boolReportKeys[i]);
-		currentModel.mCGAReport[pyKey] = boolReportValues[i];
-	}
+	for (size_t i = 0; i < boolReportCount; i++)
+		currentModel.mReports.emplace_back(boolReportKeys[i], boolReportValues[i]);
 
-	for (size_t i = 0; i < floatReportCount; i++) {
-		py::object pyKey = py::cast(floatReportKeys[i]);
-		currentModel.mCGAReport[pyKey] = floatReportValues[i];
-	}
+	for (size_t i = 0; i < floatReportCount; i++)
+		currentModel.mReports.emplace_back(floatReportKeys[i], floatReportValues[i]);
 
-	for (size_t i = 0; i < stringReportCount; i++) {
-		py::object pyKey = py::cast(stringReportKeys[i]);
-		currentModel.mCGAReport[pyKey] = stringReportValues[i];
-	}
+	for (size_t i = 0; i < stringReportCount; i++)
+		currentModel.mReports.emplace_back(stringReportKeys[i], std::wstring(stringReportValues[i]));
 }
 
 GeneratedPayloadPtr PyCallbacks::getGeneratedPayload(size_t initialShapeIndex) {
 	if (initialShapeIndex >= mPayloads.size())
 		throw std::out_of_range("initial shape index is out of range.");
+	GeneratedPayload& payload = getOrCreate(initialShapeIndex); // shapes without any output get an empty payload
+	if (!payload.mInstances.empty())
+		payload.mPrototypes = mPrototypes;
 	return mPayloads[initialShapeIndex];
 }
 
-bool PyCallbacks::isHiddenAttribute(const wchar_t* key) {
-	if (key != nullptr) {
-		auto it = std::find(mHiddenAttrs.begin(), mHiddenAttrs.end(), key);
-		if (it != mHiddenAttrs.end())
-			return true;
-	}
-
-	return false;
-}
-
 GeneratedPayload& PyCallbacks::getOrCreate(size_t initialShapeIndex) {
 	assert(mPayloads.size() > initialShapeIndex);
 	if (!mPayloads[initialShapeIndex]) {
 		mPayloads[initialShapeIndex] = std::make_shared<GeneratedPayload>();
+		mPayloads[initialShapeIndex]->mAttributeKeys = mAttributeKeys;
 	}
 	return *mPayloads[initialShapeIndex];
 }
@@ -33,6 +33,7 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -44,7 +45,7 @@ const std::wstring ERRORLEVELS[] = {L"Error ", L"Warning ", L"Info "};
 class PyCallbacks : public IPyCallbacks {
 public:
 	PyCallbacks() = delete;
-	explicit PyCallbacks(const size_t initialShapeCount, const std::unordered_set<std::wstring>& hiddenAttrs);
+	explicit PyCallbacks(const size_t initialShapeCount, const AttributeKeyTableConstPtr& ruleAttributeKeys);
 	virtual ~PyCallbacks() = default;
 
 	// prt::Callbacks implementation
@@ -70,9 +71,18 @@ public:
 	                            size_t size, size_t nRows) override;
 
 	// IPyCallbacks implementation
-	void addGeometry(const size_t initialShapeIndex, const double* vertexCoords, const size_t vextexCoordsCount,
-	                 const uint32_t* faceIndices, const size_t faceIndicesCount, const uint32_t* faceCounts,
-	                 const size_t faceCountsCount) override;
+	void addGeometry(const size_t initialShapeIndex, std::vector<double>&& vertexCoords,
+	                 std::vector<uint32_t>&& faceIndices, std::vector<uint32_t>&& faceCounts) override;
+	void addLocalGeometry(const size_t initialShapeIndex, const double* origin, std::vector<float>&& vertexCoords,
+	                      std::vector<uint32_t>&& faceIndices, std::vector<uint32_t>&& faceCounts) override;
+	void addCompactGeometry(const size_t initialShapeIndex, std::vector<uint8_t>&& buffer) override;
+	void addSummary(const size_t initialShapeIndex, const GeometrySummary& summary) override;
+	void addFaceShapeIds(const size_t initialShapeIndex, std::vector<uint32_t>&& faceShapeIds,
+	                     std::vector<std::wstring>&& shapeNames) override;
+	uint32_t addPrototype(std::vector<double>&& vertexCoords, std::vector<uint32_t>&& faceIndices,
+	                      std::vector<uint32_t>&& faceCounts) override;
+	void addInstance(const size_t initialShapeIndex, const uint32_t prototypeId,
+	                 const double* transformation) override;
 	void addReports(const size_t initialShapeIndex, const wchar_t** stringReportKeys,
 	                const wchar_t** stringReportValues, size_t stringReportCount, const wchar_t** floatReportKeys,
 	                const double* floatReportValues, size_t floatReportCount, const wchar_t** boolReportKeys,
@@ -80,51 +90,36 @@ public:
 
 	// PyCallbacks implementation
 	GeneratedPayloadPtr getGeneratedPayload(size_t initialShapeIndex);
+	const PrototypeTablePtr& getPrototypes() const {
+		return mPrototypes;
+	}
 
-	template <typename T>
-	prt::Status storeAttr(size_t isIndex, const wchar_t* key, const T value) {
-		if (!isHiddenAttribute(key)) {
-			pybind11::object pyKey = py::cast(pcu::removeDefaultStyleName(key));
-			mPayloads[isIndex]->mAttrVal[pyKey] = value;
-		}
+	prt::Status storeAttr(size_t isIndex, const wchar_t* key, AttributeValue&& value) {
+		const AttributeKey* attributeKey = mAttributeKeys->intern(key);
+		if (!attributeKey->mHidden)
+			getOrCreate(isIndex).mAttributes.emplace_back(attributeKey, std::move(value));
 
 		return prt::STATUS_OK;
 	}
 
-	template <typename T>
+	template <typename V, typename T>
 	prt::Status storeAttr(size_t isIndex, const wchar_t* key, const T* ptr, const size_t size, const size_t nRows) {
-		if (!isHiddenAttribute(key)) {
-			pybind11::object pyKey = py::cast(pcu::removeDefaultStyleName(key));
-			const size_t nCol = size / nRows;
-
-			if (nRows > 1) {
-				std::vector<std::vector<T>> values(nRows, std::vector<T>(nCol));
-				for (size_t i = 0; i < size; i++) {
-					const size_t j = i / nCol;
-					const size_t k = i % nCol;
-					values[j][k] = ptr[i];
-				}
-
-				mPayloads[isIndex]->mAttrVal[pyKey] = values;
-				return prt::STATUS_OK;
-			}
-			else {
-				std::vector<T> values(nCol);
-				for (size_t i = 0; i < size; i++)
-					values[i] = ptr[i];
-
-				mPayloads[isIndex]->mAttrVal[pyKey] = values;
-				return prt::STATUS_OK;
-			}
+		const AttributeKey* attributeKey = mAttributeKeys->intern(key);
+		if (!attributeKey->mHidden) {
+			AttributeArray<V> values;
+			values.mValues.assign(ptr, ptr + size);
+			values.mRows = nRows;
+			getOrCreate(isIndex).mAttributes.emplace_back(attributeKey, std::move(values));
 		}
 
 		return prt::STATUS_OK;
 	}
 
 private:
-	bool isHiddenAttribute(const wchar_t* key);
 	GeneratedPayload& getOrCreate(size_t initialShapeIndex);
 
 	std::vector<GeneratedPayloadPtr> mPayloads;
-	std::unordered_set<std::wstring> mHiddenAttrs;
+	AttributeKeyTablePtr mAttributeKeys; // on top of the rule package keys, shared with the payloads
+	PrototypeTablePtr mPrototypes;       // stays empty if the geometry is not instanced
+	std::mutex mPrototypeMutex;          // guards mPrototypes in addPrototype()
 };
@@ -21,10 +21,35 @@
 
 #include "pybind11/pybind11.h"
 
+#include <mutex>
 #include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::mutex thePendingMessagesMutex;
+std::vector<std::wstring> thePendingMessages;
+
+} // namespace
 
 void PythonLogHandler::handleLogEvent(const wchar_t* msg, prt::LogLevel /*level*/) {
-	pybind11::print(L"[PRT]", msg);
+	{
+		std::lock_guard<std::mutex> lock(thePendingMessagesMutex);
+		thePendingMessages.emplace_back(msg);
+	}
+	if (PyGILState_Check() != 0)
+		flushPendingMessages();
+}
+
+void PythonLogHandler::flushPendingMessages() {
+	std::vector<std::wstring> messages;
+	{
+		std::lock_guard<std::mutex> lock(thePendingMessagesMutex);
+		messages.swap(thePendingMessages);
+	}
+	for (const std::wstring& msg : messages)
+		pybind11::print(L"[PRT]", msg);
 }
 
 const prt::LogLevel* PythonLogHandler::getLevels(size_t* count) {
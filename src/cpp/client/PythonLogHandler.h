@@ -25,6 +25,9 @@
 
 /**
  * custom console logger to redirect PRT log events into the python output
+ *
+ * PRT also logs from its worker threads, which must not wait for the GIL: the messages of threads without the GIL are
+ * queued and printed by the next thread which logs with the GIL held or calls flushPendingMessages().
  */
 class PythonLogHandler : public prt::LogHandler {
 public:
@@ -34,4 +37,7 @@ public:
 	void handleLogEvent(const wchar_t* msg, prt::LogLevel level) override;
 	const prt::LogLevel* getLevels(size_t* count) override;
 	void getFormat(bool* dateTime, bool* level) override;
+
+	// prints the queued messages, must be called with the GIL held
+	static void flushPendingMessages();
 };
@@ -0,0 +1,131 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#include "RulePackageRegistry.h"
+#include "logging.h"
+#include "utils.h"
+
+#include <system_error>
+
+namespace {
+
+std::filesystem::path getCanonicalPath(const std::filesystem::path& rulePackagePath) {
+	std::error_code ec;
+	const std::filesystem::path canonicalPath = std::filesystem::canonical(rulePackagePath, ec);
+	return ec ? rulePackagePath : canonicalPath;
+}
+
+RulePackagePtr loadRulePackage(const std::filesystem::path& rulePackagePath, prt::CacheObject* cache,
+                               prt::Status& status) {
+	auto rulePackage = std::make_shared<RulePackage>();
+
+	if (!pcu::getResolveMap(rulePackagePath, &rulePackage->mResolveMap)) {
+		status = prt::STATUS_RESOLVEMAP_PROVIDER_NOT_FOUND;
+		return {};
+	}
+
+	rulePackage->mRuleFile = pcu::getRuleFileEntry(rulePackage->mResolveMap.get());
+
+	const wchar_t* ruleFileURI = rulePackage->mResolveMap->getString(rulePackage->mRuleFile.c_str());
+	if (ruleFileURI == nullptr) {
+		LOG_ERR << "could not find rule file URI in resolve map of rule package " << rulePackagePath;
+		status = prt::STATUS_INVALID_URI;
+		return {};
+	}
+
+	prt::Status infoStatus = prt::STATUS_UNSPECIFIED_ERROR;
+	rulePackage->mRuleFileInfo.reset(prt::createRuleFileInfo(ruleFileURI, cache, &infoStatus));
+	if (!rulePackage->mRuleFileInfo || infoStatus != prt::STATUS_OK) {
+		LOG_ERR << "could not get rule file info from rule file " << rulePackage->mRuleFile;
+		status = infoStatus;
+		return {};
+	}
+
+	rulePackage->mStartRule = pcu::detectStartRule(rulePackage->mRuleFileInfo);
+	rulePackage->mAttributeKeys = std::make_shared<const AttributeKeyTable>(rulePackage->mRuleFileInfo);
+	rulePackage->mAttributeTypes = pcu::getRuleAttributeTypes(rulePackage->mRuleFileInfo);
+
+	status = prt::STATUS_OK;
+	return rulePackage;
+}
+
+} // namespace
+
+RulePackageRegistry& RulePackageRegistry::instance() {
+	static RulePackageRegistry theRegistry;
+	return theRegistry;
+}
+
+RulePackagePtr RulePackageRegistry::get(const std::filesystem::path& rulePackagePath, prt::CacheObject* cache,
+                                        prt::Status& status) {
+	std::error_code ec;
+	const std::filesystem::file_time_type modificationTime = std::filesystem::last_write_time(rulePackagePath, ec);
+	const uintmax_t fileSize = ec ? 0 : std::filesystem::file_size(rulePackagePath, ec);
+	if (ec) {
+		LOG_ERR << "The rule package path is unvalid.";
+		status = prt::STATUS_FILE_NOT_FOUND;
+		return {};
+	}
+
+	const std::filesystem::path key = getCanonicalPath(rulePackagePath);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	auto it = mEntries.find(key);
+	if (it != mEntries.end() && it->second.mModificationTime == modificationTime && it->second.mFileSize == fileSize) {
+		mHits++;
+		status = prt::STATUS_OK;
+		return it->second.mRulePackage;
+	}
+
+	mMisses++;
+	RulePackagePtr rulePackage = loadRulePackage(rulePackagePath, cache, status);
+	if (rulePackage)
+		mEntries[key] = {modificationTime, fileSize, rulePackage};
+	else if (it != mEntries.end())
+		mEntries.erase(it);
+
+	return rulePackage;
+}
+
+void RulePackageRegistry::invalidate(const std::filesystem::path& rulePackagePath) {
+	const std::filesystem::path key = getCanonicalPath(rulePackagePath);
+	std::lock_guard<std::mutex> lock(mMutex);
+	mEntries.erase(key);
+}
+
+void RulePackageRegistry::clear() {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mEntries.clear();
+}
+
+size_t RulePackageRegistry::getHits() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mHits;
+}
+
+size_t RulePackageRegistry::getMisses() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mMisses;
+}
+
+size_t RulePackageRegistry::getEntryCount() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mEntries.size();
+}
@@ -0,0 +1,80 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#pragma once
+
+#include "AttributeKeyTable.h"
+#include "types.h"
+
+#include "prt/API.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Everything derived from a rule package which does not depend on the generate call.
+ */
+struct RulePackage {
+	ResolveMapPtr mResolveMap;
+	RuleFileInfoUPtr mRuleFileInfo;
+	std::wstring mRuleFile;
+	std::wstring mStartRule;
+	AttributeKeyTableConstPtr mAttributeKeys;
+	RuleAttributeTypes mAttributeTypes;
+};
+
+using RulePackagePtr = std::shared_ptr<const RulePackage>;
+
+/**
+ * Process-wide cache of rule packages. Entries are keyed by the canonical rule package path and are reloaded as soon as
+ * the modification time or the size of the file changes.
+ */
+class RulePackageRegistry {
+public:
+	static RulePackageRegistry& instance();
+
+	RulePackageRegistry(const RulePackageRegistry&) = delete;
+	RulePackageRegistry& operator=(const RulePackageRegistry&) = delete;
+
+	RulePackagePtr get(const std::filesystem::path& rulePackagePath, prt::CacheObject* cache, prt::Status& status);
+	void invalidate(const std::filesystem::path& rulePackagePath);
+	void clear();
+
+	size_t getHits() const;
+	size_t getMisses() const;
+	size_t getEntryCount() const;
+
+private:
+	RulePackageRegistry() = default;
+
+	struct Entry {
+		std::filesystem::file_time_type mModificationTime;
+		uintmax_t mFileSize = 0;
+		RulePackagePtr mRulePackage;
+	};
+
+	mutable std::mutex mMutex;
+	std::map<std::filesystem::path, Entry> mEntries;
+	size_t mHits = 0;
+	size_t mMisses = 0;
+};
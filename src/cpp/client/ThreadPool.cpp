@@ -0,0 +1,129 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threadCount) {
+	threadCount = std::max<size_t>(threadCount, 1);
+
+	mQueues.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+		mQueues.push_back(std::make_unique<WorkQueue>());
+
+	mWorkers.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+		mWorkers.emplace_back(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mTaskAvailable.notify_all();
+
+	for (std::thread& worker : mWorkers)
+		worker.join();
+}
+
+size_t ThreadPool::getThreadCount() const {
+	return mWorkers.size();
+}
+
+void ThreadPool::submit(Task task) {
+	size_t queueIndex = 0;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		queueIndex = mNextQueue;
+		mNextQueue = (mNextQueue + 1) % mQueues.size();
+		mPendingTasks++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mQueues[queueIndex]->mMutex);
+		mQueues[queueIndex]->mTasks.push_back(std::move(task));
+	}
+
+	// only count the task once it is in a queue, a worker which takes it from mQueuedTasks must find it
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mQueuedTasks++;
+	}
+	mTaskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+	std::unique_lock<std::mutex> lock(mMutex);
+	mTasksDone.wait(lock, [this]() { return mPendingTasks == 0; });
+}
+
+bool ThreadPool::popTask(size_t workerIndex, Task& task) {
+	// own queue first (front), then steal from the other queues (back)
+	for (size_t i = 0; i < mQueues.size(); i++) {
+		WorkQueue& queue = *mQueues[(workerIndex + i) % mQueues.size()];
+		std::lock_guard<std::mutex> lock(queue.mMutex);
+		if (queue.mTasks.empty())
+			continue;
+
+		if (i == 0) {
+			task = std::move(queue.mTasks.front());
+			queue.mTasks.pop_front();
+		}
+		else {
+			task = std::move(queue.mTasks.back());
+			queue.mTasks.pop_back();
+		}
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::run(size_t workerIndex) {
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mTaskAvailable.wait(lock, [this]() { return mStopping || mQueuedTasks > 0; });
+			if (mQueuedTasks == 0)
+				return; // stopping and nothing left to do
+			mQueuedTasks--; // reserves one of the queued tasks for this worker
+		}
+
+		// the reserved task is in one of the queues, a single pass can only miss it while other workers steal
+		Task task;
+		while (!popTask(workerIndex, task))
+			std::this_thread::yield();
+
+		try {
+			task();
+		}
+		catch (...) {
+			// tasks are expected to report their own errors, a failing task must not take down the worker
+		}
+
+		bool allDone = false;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			allDone = (--mPendingTasks == 0);
+		}
+		if (allDone)
+			mTasksDone.notify_all();
+	}
+}
@@ -0,0 +1,68 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Minimal work-stealing thread pool: every worker owns a task queue and takes its tasks from the front. Idle workers
+ * steal from the back of the other queues, which keeps all workers busy if the task durations vary a lot.
+ */
+class ThreadPool {
+public:
+	using Task = std::function<void()>;
+
+	explicit ThreadPool(size_t threadCount);
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	~ThreadPool();
+
+	size_t getThreadCount() const;
+
+	void submit(Task task);
+	void wait();
+
+private:
+	struct WorkQueue {
+		std::mutex mMutex;
+		std::deque<Task> mTasks;
+	};
+
+	bool popTask(size_t workerIndex, Task& task);
+	void run(size_t workerIndex);
+
+	std::vector<std::unique_ptr<WorkQueue>> mQueues;
+	std::vector<std::thread> mWorkers;
+
+	std::mutex mMutex;
+	std::condition_variable mTaskAvailable;
+	std::condition_variable mTasksDone;
+	size_t mNextQueue = 0;
+	size_t mQueuedTasks = 0;
+	size_t mPendingTasks = 0;
+	bool mStopping = false;
+};
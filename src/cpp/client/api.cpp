@@ -21,21 +21,29 @@
 #	define _CRT_SECURE_NO_WARNINGS
 #endif
 
+#include "ArrowExport.h"
+#include "EncoderOptionsCache.h"
 #include "InitialShape.h"
 #include "ModelGenerator.h"
 #include "PRTContext.h"
+#include "PythonLogHandler.h"
+#include "RulePackageRegistry.h"
 #include "doc.h"
 #include "logging.h"
 #include "utils.h"
 
+#include "encoder/CompactGeometry.h"
+
 #include "prt/API.h"
 
+#include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/stl_bind.h"
 
 #include <cstdio>
 #include <filesystem>
 #include <string>
+#include <string_view>
 #include <vector>
 #ifdef _WIN32
 #	include <direct.h>
@@ -157,40 +165,77 @@ py::dict getRuleAttributes(const prt::RuleFileInfo* ruleFileInfo) {
 }
 
 py::dict getRPKInfo(const std::filesystem::path& rulePackagePath) {
-	ResolveMapPtr resolveMap;
-
-	if (!std::filesystem::exists(rulePackagePath) || !pcu::getResolveMap(rulePackagePath, &resolveMap)) {
+	if (!std::filesystem::exists(rulePackagePath)) {
 		LOG_ERR << "invalid rule package path";
 		return {};
 	}
 
-	std::wstring ruleFile = pcu::getRuleFileEntry(resolveMap.get());
-
-	const wchar_t* ruleFileURI = resolveMap->getString(ruleFile.c_str());
-	if (ruleFileURI == nullptr) {
-		LOG_ERR << "could not find rule file URI in resolve map of rule package " << rulePackagePath;
+	prt::Status status = prt::STATUS_UNSPECIFIED_ERROR;
+	const RulePackagePtr rulePackage = RulePackageRegistry::instance().get(rulePackagePath, nullptr, status);
+	if (!rulePackage || status != prt::STATUS_OK) {
+		LOG_ERR << "invalid rule package path";
 		return {};
 	}
 
-	prt::Status infoStatus = prt::STATUS_UNSPECIFIED_ERROR;
-	RuleFileInfoUPtr info(prt::createRuleFileInfo(ruleFileURI, nullptr, &infoStatus));
-	if (!info || infoStatus != prt::STATUS_OK) {
-		LOG_ERR << "could not get rule file info from rule file " << ruleFile;
-		return {};
+	py::dict ruleAttrs = getRuleAttributes(rulePackage->mRuleFileInfo.get());
+
+	return ruleAttrs;
+}
+
+py::object decodeCompactGeometry(const py::bytes& buffer) {
+	const std::string_view data(buffer);
+	compact::Geometry geometry;
+	if (!compact::decode(reinterpret_cast<const uint8_t*>(data.data()), data.size(), geometry)) {
+		LOG_ERR << "invalid compact geometry buffer";
+		return py::none();
 	}
 
-	py::dict ruleAttrs = getRuleAttributes(info.get());
+	const auto vertexCount = static_cast<py::ssize_t>(geometry.mVertexCoords.size() / 3);
+	return py::make_tuple(py::array_t<double>({vertexCount, py::ssize_t(3)}, geometry.mVertexCoords.data()),
+	                      py::array_t<uint32_t>(geometry.mFaceIndices.size(), geometry.mFaceIndices.data()),
+	                      py::array_t<uint32_t>(geometry.mFaceCounts.size(), geometry.mFaceCounts.data()));
+}
 
-	return ruleAttrs;
+py::dict getRPKCacheStats() {
+	const RulePackageRegistry& registry = RulePackageRegistry::instance();
+	py::dict stats;
+	stats["hits"] = registry.getHits();
+	stats["misses"] = registry.getMisses();
+	stats["entries"] = registry.getEntryCount();
+	return stats;
+}
+
+void invalidateRPKCache(const std::filesystem::path& rulePackagePath) {
+	RulePackageRegistry::instance().invalidate(rulePackagePath);
+}
+
+void clearRPKCache() {
+	RulePackageRegistry::instance().clear();
 }
 
 PRTContextUPtr thePRT;
 
+void releasePRT() {
+	// cached PRT objects must be released before PRT itself is shut down
+	RulePackageRegistry::instance().clear();
+	EncoderOptionsCache::instance().clear();
+	thePRT.reset();
+}
+
 } // namespace
 
 PYBIND11_MODULE(pyprt, m) {
 	thePRT = std::make_unique<PRTContext>(prt::LOG_WARNING);
-	m.add_object("_prt_auto_shutdown", py::capsule([]() { thePRT.reset(); }));
+	m.add_object("_prt_auto_shutdown", py::capsule([]() { releasePRT(); }));
+
+	// pending asynchronous generate calls need the interpreter, they are finished before it shuts down
+	py::module_::import("atexit").attr("register")(py::cpp_function([]() {
+		{
+			py::gil_scoped_release release;
+			ModelGenerator::shutdownAsyncGeneration();
+		}
+		PythonLogHandler::flushPendingMessages();
+	}));
 
 	py::options options;
 	options.disable_function_signatures();
@@ -202,6 +247,10 @@ PYBIND11_MODULE(pyprt, m) {
 	m.def("shutdown_prt", &shutdownPRT, doc::Shutdown);
 	m.def("get_api_version", &getPRTVersion, doc::getPRTVersion);
 	m.def("get_rpk_attributes_info", &getRPKInfo, py::arg("rulePackagePath"), doc::GetRPKInfo);
+	m.def("get_rpk_cache_stats", &getRPKCacheStats, doc::GetRPKCacheStats);
+	m.def("decode_compact_geometry", &decodeCompactGeometry, py::arg("buffer"), doc::DecodeCompact);
+	m.def("invalidate_rpk_cache", &invalidateRPKCache, py::arg("rulePackagePath"), doc::InvalidateRPKCache);
+	m.def("clear_rpk_cache", &clearRPKCache, doc::ClearRPKCache);
 	m.attr("NO_KEY") = NO_KEY;
 
 	py::class_<InitialShape>(m, "InitialShape", doc::Is)
@@ -220,13 +269,63 @@ PYBIND11_MODULE(pyprt, m) {
 	        .def(py::init<const std::vector<InitialShape>&>(), py::arg("initialShapes"), doc::MgInit)
 	        .def("generate_model", &ModelGenerator::generateModel, py::arg("shapeAttributes"),
 	             py::arg("rulePackagePath"), py::arg("geometryEncoderName"), py::arg("geometryEncoderOptions"),
-	             doc::MgGen);
+	             py::arg("numThreads") = 1, py::arg("shardSize") = 0, py::arg("auxiliaryOutputs") = py::none(),
+	             doc::MgGen)
+	        .def("generate_model_async", &ModelGenerator::generateModelAsync, py::arg("shapeAttributes"),
+	             py::arg("rulePackagePath"), py::arg("geometryEncoderName"), py::arg("geometryEncoderOptions"),
+	             py::arg("numThreads") = 1, py::arg("shardSize") = 0, py::arg("auxiliaryOutputs") = py::none(),
+	             doc::MgGenAsync)
+	        .def("generate_iter", &ModelGenerator::generateIter, py::arg("shapeAttributes"),
+	             py::arg("rulePackagePath"), py::arg("geometryEncoderName"), py::arg("geometryEncoderOptions"),
+	             py::arg("chunkSize") = 1000, py::arg("numThreads") = 1, py::arg("shardSize") = 0,
+	             py::arg("auxiliaryOutputs") = py::none(), doc::MgGenIter)
+	        .def("generate_batch", &ModelGenerator::generateBatch, py::arg("shapeAttributes"),
+	             py::arg("rulePackagePath"), py::arg("geometryEncoderOptions"), py::arg("numThreads") = 1,
+	             py::arg("shardSize") = 0, py::arg("auxiliaryOutputs") = py::none(), doc::MgGenBatch);
+
+	py::class_<GeneratedModelIterator>(m, "GeneratedModelIterator", doc::Gmi)
+	        .def("__iter__", [](py::object self) { return self; })
+	        .def("__next__", &GeneratedModelIterator::next);
+
+	py::class_<GeneratedBatch, GeneratedBatchPtr>(m, "GeneratedBatch", doc::Gb)
+	        .def("__len__", &GeneratedBatch::getModelCount)
+	        .def("get_vertices_array", &GeneratedBatch::getVerticesArray, doc::GbGetVArr)
+	        .def("get_indices_array", &GeneratedBatch::getIndicesArray, doc::GbGetIArr)
+	        .def("get_faces_array", &GeneratedBatch::getFacesArray, doc::GbGetFArr)
+	        .def("get_vertex_offsets", &GeneratedBatch::getVertexOffsetsArray, doc::GbGetVOff)
+	        .def("get_index_offsets", &GeneratedBatch::getIndexOffsetsArray, doc::GbGetIOff)
+	        .def("get_face_offsets", &GeneratedBatch::getFaceOffsetsArray, doc::GbGetFOff)
+	        .def("get_report_table", &GeneratedBatch::getReportTable, doc::GbGetRepTable)
+	        .def("get_attribute_table", &GeneratedBatch::getAttributeTable, doc::GbGetAttrTable)
+	        .def("aggregate_reports", &GeneratedBatch::aggregateReports, py::arg("reportKey"),
+	             py::arg("operations") = std::vector<std::string>{"sum", "mean", "min", "max", "count"},
+	             py::arg("groupBy") = py::none(), doc::GbAggregate)
+	        .def("__arrow_c_array__", &arrow_export::toArrowArrayCapsules, py::arg("requested_schema") = py::none(),
+	             doc::GbArrowArray)
+	        .def("__arrow_c_stream__", &arrow_export::toArrowStreamCapsule, py::arg("requested_schema") = py::none(),
+	             doc::GbArrowStream);
+
+	py::class_<PrototypeTable, PrototypeTablePtr>(m, "PrototypeTable", doc::Pt)
+	        .def("__len__", &PrototypeTable::getPrototypeCount)
+	        .def("get_vertices", &PrototypeTable::getVertices, py::arg("prototypeId"), doc::PtGetV)
+	        .def("get_indices", &PrototypeTable::getIndices, py::arg("prototypeId"), doc::PtGetI)
+	        .def("get_faces", &PrototypeTable::getFaces, py::arg("prototypeId"), doc::PtGetF);
 
 	py::class_<GeneratedModel>(m, "GeneratedModel", doc::Gm)
 	        .def("get_initial_shape_index", &GeneratedModel::getInitialShapeIndex, doc::GmGetInd)
 	        .def("get_vertices", &GeneratedModel::getVertices, doc::GmGetV)
 	        .def("get_indices", &GeneratedModel::getIndices, doc::GmGetI)
 	        .def("get_faces", &GeneratedModel::getFaces, doc::GmGetF)
+	        .def("get_vertices_array", &GeneratedModel::getVerticesArray, doc::GmGetVArr)
+	        .def("get_origin", &GeneratedModel::getOrigin, doc::GmGetOrig)
+	        .def("get_compact_geometry", &GeneratedModel::getCompactGeometry, doc::GmGetCompact)
+	        .def("get_summary", &GeneratedModel::getSummary, doc::GmGetSummary)
+	        .def("get_face_shape_ids_array", &GeneratedModel::getFaceShapeIdsArray, doc::GmGetFaceShapeIds)
+	        .def("get_shape_names", &GeneratedModel::getShapeNames, doc::GmGetShapeNames)
+	        .def("get_indices_array", &GeneratedModel::getIndicesArray, doc::GmGetIArr)
+	        .def("get_faces_array", &GeneratedModel::getFacesArray, doc::GmGetFArr)
+	        .def("get_instances", &GeneratedModel::getInstances, doc::GmGetInst)
+	        .def("get_prototypes", &GeneratedModel::getPrototypes, doc::GmGetProto)
 	        .def("get_report", &GeneratedModel::getReport, doc::GmGetR)
 	        .def("get_cga_prints", &GeneratedModel::getCGAPrints, doc::GmGetP)
 	        .def("get_cga_errors", &GeneratedModel::getCGAErrors, doc::GmGetE)
@@ -72,6 +72,33 @@ constexpr const char* GetRPKInfo = R"mydelimiter(
             dict
     )mydelimiter";
 
+constexpr const char* GetRPKCacheStats = R"mydelimiter(
+        get_rpk_cache_stats() -> dict
+
+        Rule packages are loaded once and kept in a process-wide cache, which is shared by all
+        :py:class:`ModelGenerator <pyprt.pyprt.bin.pyprt.ModelGenerator>` instances. A cached rule package is reloaded
+        as soon as its modification time or file size changes. This function returns the number of cache ``'hits'``,
+        ``'misses'`` and the number of currently cached rule packages (``'entries'``).
+
+        :Returns:
+            dict
+    )mydelimiter";
+
+constexpr const char* InvalidateRPKCache = R"mydelimiter(
+        invalidate_rpk_cache(rule_package_path)
+
+        Removes the specified rule package from the process-wide rule package cache. It will be reloaded on next use.
+
+        :Parameters:
+            **rule_package_path** -- str
+    )mydelimiter";
+
+constexpr const char* ClearRPKCache = R"mydelimiter(
+        clear_rpk_cache()
+
+        Removes all rule packages from the process-wide rule package cache.
+    )mydelimiter";
+
 constexpr const char* Is = R"mydelimiter(
         __init__(*args, **kwargs)
 
@@ -167,6 +194,24 @@ constexpr const char* IsGetP = R"mydelimiter(
             str
         )mydelimiter";
 
+constexpr const char* DecodeCompact = R"mydelimiter(
+        decode_compact_geometry(buffer) -> Tuple[numpy.ndarray, numpy.ndarray, numpy.ndarray]
+
+        Decodes a buffer returned by :py:meth:`get_compact_geometry
+        <pyprt.pyprt.bin.pyprt.GeneratedModel.get_compact_geometry>` into the (N, 3) float64 vertex coordinates, the
+        uint32 vertex indices and the uint32 vertex indices count per face. The vertex coordinates are exact up to the
+        quantization step, i.e. the bounding box size divided by 2^16 - 1 (or 2^32 - 1). Returns None for an invalid
+        buffer.
+
+        The buffer is not compressed: the size reduction only comes from the quantization and the delta encoding, no
+        entropy compression (e.g. zlib or zstd) is applied. Compress the buffer yourself to store or send it.
+
+        :Parameters:
+            - **buffer** -- bytes
+        :Returns:
+            Tuple[numpy.ndarray, numpy.ndarray, numpy.ndarray]
+        )mydelimiter";
+
 constexpr const char* Mg =
         "The ModelGenerator class will host the data required to procedurally generate the 3D model on "
         "a given initial shape.";
@@ -190,19 +235,58 @@ constexpr const char* MgGen = R"mydelimiter(
         ``'seed'`` value, which has to be an integer (default value equals to *0*). The ``'shapeName'`` is
         another non-mandatory entry (default value equals to *"InitialShape"*). In addition to the seed and the shape name keys,
         the shape attribute dictionary will contain the CGA input attributes specific to the CGA file you are using (use the
-        ``get_rpk_attributes_info`` function to know these input attributes). Concerning the encoder, you can use the
-        ``'com.esri.pyprt.PyEncoder'`` or any other geometry encoder. The PyEncoder has these options:
-        ``'emitGeometry'``, ``'emitReport'`` and ``'triangulate'`` whose value is a boolean. The complete list of the other geometry
+        ``get_rpk_attributes_info`` function to know these input attributes). The values of these attributes are
+        converted to the types declared in the CGA file (integers are accepted for float attributes). If a value does
+        not match the declared type, an error is logged and an empty list is returned. Concerning the encoder, you can
+        use the ``'com.esri.pyprt.PyEncoder'`` or any other geometry encoder. The PyEncoder has these options:
+        ``'emitGeometry'``, ``'emitReport'``, ``'triangulate'`` and ``'mergeVertices'`` whose value is a boolean, and
+        ``'mergeTolerance'`` whose value is a float. With ``'mergeVertices'``, the faces of a mesh share their vertices.
+        Vertices closer than ``'mergeTolerance'`` are welded; a negative tolerance is rejected with an error. With the
+        boolean option ``'instancing'``, every distinct mesh (e.g. an inserted asset) is returned once as a prototype,
+        also when the call is sharded, and the models contain instances of the prototypes instead of vertices. With
+        the boolean option ``'float32Vertices'``, the vertex coordinates are returned as float32 relative to a local
+        origin: to ``'localOrigin'`` (a list of 3 floats, e.g. the center of a tile) if given, otherwise to the center
+        of the bounding box of each model. With the boolean option ``'compactGeometry'``, the geometry of each model is
+        returned as one buffer with the vertices quantized to ``'quantizationBits'`` (16 or 32) bits inside the
+        bounding box and delta-encoded indices, see ``GeneratedModel.get_compact_geometry``. No entropy compression is
+        applied. Other ``'quantizationBits'`` values are rejected with an error. ``'compactGeometry'`` takes
+        precedence over ``'float32Vertices'``. With ``'emitSummary'``, the PyEncoder computes the footprint area,
+        surface area, volume, height and bounding box of each model, see ``GeneratedModel.get_summary``; combined
+        with ``'emitGeometry'`` set to False, no geometry is returned at all. With ``'emitFaceShapeIds'``, each face
+        is tagged with the CGA leaf shape it comes from, see ``GeneratedModel.get_face_shape_ids_array``; the meshes
+        of different leaf shapes are then not merged. The complete list of the other geometry
         encoders can be found `here <https://esri.github.io/cityengine-sdk/html/esri_prt_codecs.html>`__. In
         case you are using another geometry encoder than the PyEncoder, you can add an ``'outputPath'`` entry to
         the shape attribute dictionary to specify where the generated 3D geometry will be outputted. In this case,
         the return value of this *generate_model* function will be an empty list.
 
+        Instead of a list of dictionaries, the shape attributes can also be given as one dictionary of attribute
+        columns, e.g. ``{'minBuildingHeight': numpy.array([10.0, 20.0]), 'style': ['a', 'b']}``. Each column is a NumPy
+        array or a list with one value per initial shape (two-dimensional arrays provide one array attribute per
+        initial shape). The type of a column is determined once, which makes this form much faster for many initial
+        shapes.
+
+        With the PyEncoder, the initial shapes can be generated in parallel: they are split into shards of *shard_size*
+        initial shapes, which are distributed on a work-stealing pool of *num_threads* threads. Each shard is generated
+        by its own PRT generate call, the results are returned in initial shape order. Use *num_threads* = 0 to use all
+        available cores and *shard_size* = 0 to derive the shard size from the number of threads. By default, all
+        initial shapes are generated by a single PRT generate call. The pool is kept by the ModelGenerator and reused by
+        its generate calls as long as *num_threads* does not change.
+
+        By default, the CGA reports, prints, errors and the evaluated rule attributes are collected next to the
+        geometry. *auxiliary_outputs* selects a subset of them with the names ``'report'``, ``'print'``, ``'errors'``
+        and ``'attributes'``, e.g. ``auxiliaryOutputs=set()`` for geometry only. The outputs which are not selected are
+        not computed and are empty in the generated models. The reports of the PyEncoder are still controlled by its
+        ``'emitReport'`` option.
+
         :Parameters:
-            - **shape_attributes** -- List[dict]
+            - **shape_attributes** -- List[dict] or dict
             - **rule_package_path** -- str
             - **geometry_encoder** -- str
             - **encoder_options** -- dict
+            - **num_threads** -- int (optional, default: 1)
+            - **shard_size** -- int (optional, default: 0)
+            - **auxiliary_outputs** -- Set[str] (optional, default: None)
 
         :Returns:
             List[GeneratedModel]
@@ -218,11 +302,265 @@ constexpr const char* MgGen = R"mydelimiter(
             ``models1 = m.generate_model([attrs1, attrs2], rpk, 'com.esri.pyprt.PyEncoder', {'emitReport': True, 'emitGeometry': True})``
         )mydelimiter";
 
+constexpr const char* MgGenAsync = R"mydelimiter(
+        generate_model_async(*args, **kwargs) -> concurrent.futures.Future
+
+        Asynchronous variant of :py:meth:`generate_model <pyprt.pyprt.bin.pyprt.ModelGenerator.generate_model>`
+        with the same parameters. The shape attributes and encoder options are converted right away, the generation
+        itself runs on a background thread without holding the GIL. The returned future resolves to the list of
+        :py:class:`GeneratedModel <pyprt.pyprt.bin.pyprt.GeneratedModel>` instances (an empty list in case of an
+        error, like *generate_model*). The future can be cancelled as long as the generation has not started. Use
+        ``asyncio.wrap_future`` to await it in a coroutine.
+
+        :Parameters:
+            - **shape_attributes** -- List[dict] or dict
+            - **rule_package_path** -- str
+            - **geometry_encoder** -- str
+            - **encoder_options** -- dict
+            - **num_threads** -- int (optional, default: 1)
+            - **shard_size** -- int (optional, default: 0)
+            - **auxiliary_outputs** -- Set[str] (optional, default: None)
+
+        :Returns:
+            concurrent.futures.Future
+        :Example:
+            ``future = m.generate_model_async([attrs], rpk, 'com.esri.pyprt.PyEncoder', {})``
+
+            ``models = await asyncio.wrap_future(future)``
+        )mydelimiter";
+
+constexpr const char* MgGenIter = R"mydelimiter(
+        generate_iter(*args, **kwargs) -> GeneratedModelIterator
+
+        Streaming variant of :py:meth:`generate_model <pyprt.pyprt.bin.pyprt.ModelGenerator.generate_model>`. The
+        initial shapes are generated in chunks of *chunk_size* initial shapes, the returned iterator yields one list of
+        :py:class:`GeneratedModel <pyprt.pyprt.bin.pyprt.GeneratedModel>` instances per chunk. The next chunk is
+        generated in the background while the current one is processed, which bounds the memory to about two chunks.
+        The iteration stops early if a chunk cannot be generated.
+
+        :Parameters:
+            - **shape_attributes** -- List[dict] or dict
+            - **rule_package_path** -- str
+            - **geometry_encoder** -- str
+            - **encoder_options** -- dict
+            - **chunk_size** -- int (optional, default: 1000)
+            - **num_threads** -- int (optional, default: 1)
+            - **shard_size** -- int (optional, default: 0)
+            - **auxiliary_outputs** -- Set[str] (optional, default: None)
+
+        :Returns:
+            GeneratedModelIterator
+        :Example:
+            ``for models in m.generate_iter([attrs], rpk, 'com.esri.pyprt.PyEncoder', {}, chunkSize=500):``
+
+            ``    process(models)``
+        )mydelimiter";
+
+constexpr const char* MgGenBatch = R"mydelimiter(
+        generate_batch(*args, **kwargs) -> GeneratedBatch
+
+        Generates the models with the *com.esri.pyprt.PyEncoder* like :py:meth:`generate_model
+        <pyprt.pyprt.bin.pyprt.ModelGenerator.generate_model>`, but returns the geometry of all models in one
+        :py:class:`GeneratedBatch <pyprt.pyprt.bin.pyprt.GeneratedBatch>` with concatenated NumPy buffers. Reports,
+        prints and errors are not collected. The reports of the PyEncoder (``'emitReport'``) and the rule attributes
+        (with ``'attributes'`` in *auxiliary_outputs*) are collected into one column per key for the Arrow export.
+        Float32 vertices are returned as absolute float64 coordinates. The ``'compactGeometry'`` and ``'instancing'``
+        options are not supported, an error is logged for them. The batch is empty if the generation fails.
+
+        :Parameters:
+            - **shape_attributes** -- List[dict] or dict
+            - **rule_package_path** -- str
+            - **encoder_options** -- dict
+            - **num_threads** -- int (optional, default: 1)
+            - **shard_size** -- int (optional, default: 0)
+            - **auxiliary_outputs** -- Set[str] (optional, default: None)
+
+        :Returns:
+            GeneratedBatch
+        :Example:
+            ``batch = m.generate_batch([attrs], rpk, {}, numThreads=8)``
+        )mydelimiter";
+
+constexpr const char* Gmi = "Iterator over the chunks of generated models returned by :py:meth:`generate_iter "
+                            "<pyprt.pyprt.bin.pyprt.ModelGenerator.generate_iter>`.";
+
 constexpr const char* Gm =
         "The GeneratedModel instance contains the generated 3D geometry. This class is only employed "
         "if the *com.esri.pyprt.PyEncoder* encoder is used in the :py:class:`ModelGenerator "
         "<pyprt.pyprt.bin.pyprt.ModelGenerator>` instance.";
 
+constexpr const char* Gb =
+        "The GeneratedBatch contains the generated 3D geometry of all models of a :py:meth:`generate_batch "
+        "<pyprt.pyprt.bin.pyprt.ModelGenerator.generate_batch>` call in concatenated buffers. The offset arrays have "
+        "one entry per model plus one, the data of model *i* is in ``[offsets[i], offsets[i + 1])``. Its length is "
+        "the number of models.";
+
+constexpr const char* GbGetRepTable = R"mydelimiter(
+        get_report_table() -> Dict[str, numpy.ma.MaskedArray]
+
+        Returns the reports of all models as one column per report key, with one entry per model. The columns are
+        NumPy masked arrays of float64, bool or str (object) values, depending on the type of the first value of the
+        key. The entries of models without a value of this type for the key are masked.
+
+        :Returns:
+            Dict[str, numpy.ma.MaskedArray]
+        :Example:
+            ``gfa = batch.get_report_table()['Floor area_sum'].sum()``
+        )mydelimiter";
+
+constexpr const char* GbGetAttrTable = R"mydelimiter(
+        get_attribute_table() -> Dict[str, numpy.ma.MaskedArray]
+
+        Returns the scalar rule attributes of all models as one column per attribute, like :py:meth:`get_report_table
+        <pyprt.pyprt.bin.pyprt.GeneratedBatch.get_report_table>`. Requires ``'attributes'`` in the *auxiliary_outputs*
+        of :py:meth:`generate_batch <pyprt.pyprt.bin.pyprt.ModelGenerator.generate_batch>`.
+
+        :Returns:
+            Dict[str, numpy.ma.MaskedArray]
+        )mydelimiter";
+
+constexpr const char* GbAggregate = R"mydelimiter(
+        aggregate_reports(reportKey, operations=['sum', 'mean', 'min', 'max', 'count'], groupBy=None) -> dict
+
+        Aggregates a float or bool report (bools count as 0 and 1) over all models in C++. The supported operations are
+        ``'sum'``, ``'mean'``, ``'min'``, ``'max'`` and ``'count'``, models without the report are skipped. The count
+        is an int. The mean, min and max of a group without values are NaN. If *groupBy* is set, the result has one
+        entry per value of the named key. The key is looked up in the shape attributes passed to
+        :py:meth:`generate_batch <pyprt.pyprt.bin.pyprt.ModelGenerator.generate_batch>` first. Then it is looked up in
+        the evaluated rule attributes (see :py:meth:`get_attribute_table
+        <pyprt.pyprt.bin.pyprt.GeneratedBatch.get_attribute_table>`) and in the reports. Models without this value or
+        with NaN are grouped under None. An error is logged and an empty dictionary is returned for unknown keys or
+        operations.
+
+        :Parameters:
+            - **reportKey** -- str
+            - **operations** -- List[str] (optional, default: all operations)
+            - **groupBy** -- str (optional, default: None)
+        :Returns:
+            Dict[str, Union[float, int]] or Dict[Any, Dict[str, Union[float, int]]]
+        :Example:
+            ``batch.aggregate_reports('GFA', ['sum'], groupBy='zoning')  # {'residential': {'sum': 2030.5}, ...}``
+        )mydelimiter";
+
+constexpr const char* GbArrowArray = R"mydelimiter(
+        __arrow_c_array__(requested_schema=None) -> Tuple[object, object]
+
+        Exports the batch through the Arrow PyCapsule interface as a record batch with one row per model, in initial
+        shape order. The ``vertices`` column is a GeoArrow ``geoarrow.multipoint`` with interleaved xyz coordinates,
+        ``indices`` and ``faces`` are lists of uint32. If present, the ``report`` and ``attributes`` columns are structs
+        with one typed field per report key and scalar rule attribute, missing values are null. The geometry buffers
+        are shared with the batch, e.g. ``pyarrow.record_batch(batch)`` does not copy them.
+
+        :Returns:
+            Tuple[object, object]
+        )mydelimiter";
+
+constexpr const char* GbArrowStream = R"mydelimiter(
+        __arrow_c_stream__(requested_schema=None) -> object
+
+        Exports the batch through the Arrow PyCapsule interface as a stream of one record batch, see
+        ``__arrow_c_array__``. This allows e.g. ``polars.DataFrame(batch)`` or ``duckdb.sql('SELECT * FROM batch')``.
+
+        :Returns:
+            object
+        )mydelimiter";
+
+constexpr const char* GbGetVArr = R"mydelimiter(
+        get_vertices_array() -> numpy.ndarray
+
+        Returns the vertex coordinates of all models as a read-only float64 NumPy array of shape (n, 3).
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* GbGetIArr = R"mydelimiter(
+        get_indices_array() -> numpy.ndarray
+
+        Returns the vertex indices of all models as a read-only uint32 NumPy array. The indices are relative to the
+        first vertex of their model, add ``get_vertex_offsets()[i]`` for the row in ``get_vertices_array()``.
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* GbGetFArr = R"mydelimiter(
+        get_faces_array() -> numpy.ndarray
+
+        Returns the vertex indices count per face of all models as a read-only uint32 NumPy array.
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* GbGetVOff = R"mydelimiter(
+        get_vertex_offsets() -> numpy.ndarray
+
+        Returns the first vertex (row of ``get_vertices_array()``) of each model and the total vertex count as a
+        read-only uint64 NumPy array.
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* GbGetIOff = R"mydelimiter(
+        get_index_offsets() -> numpy.ndarray
+
+        Returns the first entry of ``get_indices_array()`` of each model and the total index count as a read-only
+        uint64 NumPy array.
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* GbGetFOff = R"mydelimiter(
+        get_face_offsets() -> numpy.ndarray
+
+        Returns the first entry of ``get_faces_array()`` of each model and the total face count as a read-only uint64
+        NumPy array.
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* Pt =
+        "The PrototypeTable contains the prototype meshes of a generate call with instancing, see "
+        ":py:meth:`get_prototypes <pyprt.pyprt.bin.pyprt.GeneratedModel.get_prototypes>`. The prototype ID is the "
+        "index in the table.";
+
+constexpr const char* PtGetV = R"mydelimiter(
+        get_vertices(prototype_id) -> List[float]
+
+        Returns the vertex coordinates of the prototype mesh, in the local coordinates of the prototype.
+
+        :Parameters:
+            - **prototype_id** -- int
+        :Returns:
+            List[float]
+        )mydelimiter";
+
+constexpr const char* PtGetI = R"mydelimiter(
+        get_indices(prototype_id) -> List[int]
+
+        Returns the vertex indices of all faces of the prototype mesh.
+
+        :Parameters:
+            - **prototype_id** -- int
+        :Returns:
+            List[int]
+        )mydelimiter";
+
+constexpr const char* PtGetF = R"mydelimiter(
+        get_faces(prototype_id) -> List[int]
+
+        Returns the vertex indices count per face of the prototype mesh.
+
+        :Parameters:
+            - **prototype_id** -- int
+        :Returns:
+            List[int]
+        )mydelimiter";
+
 constexpr const char* GmGetInd = R"mydelimiter(
         get_initial_shape_index() -> int
 
@@ -240,7 +578,8 @@ constexpr const char* GmGetV = R"mydelimiter(
 
         Returns the generated 3D geometry vertex coordinates as a series of (x, y, z) triplets. Its size is 3 x the
         number of vertices. If the ``'emitGeometry'`` entry of the encoder options dictionary has been set to *False*,
-        this function returns an empty vector.
+        this function returns an empty vector. With the ``'float32Vertices'`` encoder option, the vertex coordinates are
+        only available from ``get_vertices_array``.
 
         :Returns:
             List[float]
@@ -266,6 +605,116 @@ constexpr const char* GmGetF = R"mydelimiter(
             List[int]
         )mydelimiter";
 
+constexpr const char* GmGetVArr = R"mydelimiter(
+        get_vertices_array() -> numpy.ndarray
+
+        Returns the vertex coordinates of the generated 3D geometry as a read-only (N, 3) float64 array, with N the
+        number of vertices. The array is a view on the geometry buffer of the generated model, no data is copied.
+        With the ``'float32Vertices'`` encoder option, the array is a float32 array relative to ``get_origin``.
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* GmGetCompact = R"mydelimiter(
+        get_compact_geometry() -> bytes
+
+        Returns the generated 3D geometry as one compact buffer if the ``'compactGeometry'`` entry of the PyEncoder
+        options is set to True, empty bytes otherwise. No entropy compression is applied. Use
+        :py:meth:`decode_compact_geometry <pyprt.pyprt.bin.pyprt.decode_compact_geometry>` to read it.
+
+        :Returns:
+            bytes
+        )mydelimiter";
+
+constexpr const char* GmGetSummary = R"mydelimiter(
+        get_summary() -> Dict[str, Any]
+
+        Returns the geometric summary of the generated model if the ``'emitSummary'`` entry of the PyEncoder options
+        is set to True, an empty dictionary otherwise. The entries are ``'footprintArea'`` (area of the initial shape
+        in the x-z ground plane), ``'surfaceArea'``, ``'volume'`` (only meaningful for closed geometry), ``'height'``
+        (extent along the y axis) and the corners ``'boundingBoxMin'`` and ``'boundingBoxMax'`` of the axis-aligned
+        bounding box.
+
+        :Returns:
+            Dict[str, Any]
+        )mydelimiter";
+
+constexpr const char* GmGetFaceShapeIds = R"mydelimiter(
+        get_face_shape_ids_array() -> numpy.ndarray
+
+        Returns one leaf shape ID per face of the generated 3D geometry (in the order of ``get_faces()``) as a
+        read-only uint32 NumPy array, if the ``'emitFaceShapeIds'`` entry of the PyEncoder options is set to True. The
+        IDs index into :py:meth:`get_shape_names
+        <pyprt.pyprt.bin.pyprt.GeneratedModel.get_shape_names>`. The array is empty otherwise or with the
+        ``'instancing'`` option.
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* GmGetShapeNames = R"mydelimiter(
+        get_shape_names() -> List[str]
+
+        Returns the CGA shape name of each leaf shape of the generated model, indexed by the IDs of
+        :py:meth:`get_face_shape_ids_array <pyprt.pyprt.bin.pyprt.GeneratedModel.get_face_shape_ids_array>`.
+
+        :Returns:
+            List[str]
+        )mydelimiter";
+
+constexpr const char* GmGetOrig = R"mydelimiter(
+        get_origin() -> List[float]
+
+        Returns the (x, y, z) origin of the float32 vertex coordinates, see the ``'float32Vertices'`` and
+        ``'localOrigin'`` encoder options. The absolute coordinates are ``get_vertices_array() + get_origin()``. The
+        origin is (0, 0, 0) for float64 vertex coordinates.
+
+        :Returns:
+            List[float]
+        )mydelimiter";
+
+constexpr const char* GmGetIArr = R"mydelimiter(
+        get_indices_array() -> numpy.ndarray
+
+        Returns the vertex indices of the generated 3D geometry faces as a read-only uint32 array view, see
+        ``get_indices``.
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* GmGetFArr = R"mydelimiter(
+        get_faces_array() -> numpy.ndarray
+
+        Returns the vertex indices count per face of the generated 3D geometry as a read-only uint32 array view, see
+        ``get_faces``.
+
+        :Returns:
+            numpy.ndarray
+        )mydelimiter";
+
+constexpr const char* GmGetInst = R"mydelimiter(
+        get_instances() -> List[Tuple[int, numpy.ndarray]]
+
+        Returns the instances of the generated model if the ``'instancing'`` entry of the PyEncoder options is set to
+        True. Each instance is a tuple of the prototype ID and the 4x4 transformation matrix which places the
+        prototype, see ``get_prototypes``. Empty if instancing is not used.
+
+        :Returns:
+            List[Tuple[int, numpy.ndarray]]
+        )mydelimiter";
+
+constexpr const char* GmGetProto = R"mydelimiter(
+        get_prototypes() -> PrototypeTable
+
+        Returns the prototype meshes referred to by the instances of the generated model. The table is shared by all
+        models of a generate call. None if the model has no instances.
+
+        :Returns:
+            PrototypeTable
+        )mydelimiter";
+
 constexpr const char* GmGetR = R"mydelimiter(
         get_report() -> dict
 
@@ -299,7 +748,9 @@ constexpr const char* GmGetE = R"mydelimiter(
 constexpr const char* GmGetAttr = R"mydelimiter(
         get_attributes() -> dict
 
-        Returns a dictionary with the CGA rule attributes name and value used to generate this model.
+        Returns a dictionary with the CGA rule attributes name and value used to generate this model. Float and boolean
+        array attributes are returned as NumPy arrays (two-dimensional for attributes with more than one row), string
+        arrays are returned as (nested) lists.
 
         :Returns:
             dict
@@ -24,12 +24,17 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 using Coordinates = std::vector<double>;
 using Indices = std::vector<uint32_t>;
 using HoleIndices = std::vector<Indices>;
 
+// declared types of the rule attributes, by attribute name with and without the default style prefix
+using RuleAttributeTypes = std::unordered_map<std::wstring, prt::AnnotationArgumentType>;
+
 /**
  * helpers for prt object management
  */
@@ -47,6 +52,7 @@ using ResolveMapBuilderPtr = std::unique_ptr<prt::ResolveMapBuilder, PRTDestroye
 using InitialShapePtr = std::unique_ptr<const prt::InitialShape, PRTDestroyer>;
 using InitialShapeBuilderPtr = std::unique_ptr<prt::InitialShapeBuilder, PRTDestroyer>;
 using AttributeMapPtr = std::unique_ptr<const prt::AttributeMap, PRTDestroyer>;
+using AttributeMapSPtr = std::shared_ptr<const prt::AttributeMap>;
 using AttributeMapBuilderPtr = std::unique_ptr<prt::AttributeMapBuilder, PRTDestroyer>;
 using FileOutputCallbacksPtr = std::unique_ptr<prt::FileOutputCallbacks, PRTDestroyer>;
 using ConsoleLogHandlerPtr = std::unique_ptr<prt::ConsoleLogHandler, PRTDestroyer>;
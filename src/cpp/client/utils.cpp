@@ -22,9 +22,12 @@
 
 #include "prt/StringUtils.h"
 
+#include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
 #include <fstream>
 #include <iostream>
 
@@ -58,6 +61,282 @@ void tokenize(const std::basic_string<C>& str, std::vector<std::basic_string<C>>
 
 namespace py = pybind11;
 
+namespace {
+
+/**
+ * The rows to convert of one column of shape attributes. Numeric and bool columns are accessed through their
+ * (contiguous) NumPy buffer, string columns are decoded once into mStrings.
+ */
+struct AttributeColumn {
+	enum class Type { BOOL, INT, FLOAT, STRING };
+
+	std::wstring mKey;
+	Type mType = Type::FLOAT;
+	size_t mWidth = 0; // number of values per initial shape for array attributes, 0 for scalar attributes
+	py::array mArray;
+	std::vector<std::wstring> mStrings; // only the rows to convert
+	std::vector<const wchar_t*> mStringPtrs;
+};
+
+std::wstring toWString(const uint32_t* codePoints, size_t maxCount) {
+	std::wstring str;
+	str.reserve(maxCount);
+	for (size_t i = 0; i < maxCount && codePoints[i] != 0; i++) {
+		const uint32_t cp = codePoints[i];
+		if (sizeof(wchar_t) == 2 && cp > 0xFFFF) {
+			str.push_back(static_cast<wchar_t>(0xD800 + ((cp - 0x10000) >> 10)));
+			str.push_back(static_cast<wchar_t>(0xDC00 + ((cp - 0x10000) & 0x3FF)));
+		}
+		else
+			str.push_back(static_cast<wchar_t>(cp));
+	}
+	return str;
+}
+
+// decodes the strings of the given rows only, rows is a slice of the column
+bool decodeStringColumn(const py::array& rows, AttributeColumn& column) {
+	const size_t valueCount = static_cast<size_t>(rows.size());
+	column.mStrings.resize(valueCount);
+
+	if (rows.dtype().kind() == 'U') {
+		// fixed width UCS4 strings, padded with zeros
+		const py::array contiguous = py::array::ensure(rows, py::array::c_style);
+		const size_t charCount = static_cast<size_t>(contiguous.itemsize()) / sizeof(uint32_t);
+		const auto* data = static_cast<const uint8_t*>(contiguous.data());
+		std::vector<uint32_t> codePoints(charCount);
+		for (size_t i = 0; i < valueCount; i++) {
+			std::memcpy(codePoints.data(), data + i * contiguous.itemsize(), contiguous.itemsize());
+			column.mStrings[i] = toWString(codePoints.data(), charCount);
+		}
+	}
+	else {
+		// object arrays, each value has to be a Python string
+		const py::list values = rows.attr("ravel")().attr("tolist")();
+		for (size_t i = 0; i < valueCount; i++) {
+			const py::handle value = values[i];
+			if (!py::isinstance<py::str>(value)) {
+				LOG_ERR << L"shape attribute column " << column.mKey << L" contains a value which is not a string";
+				return false;
+			}
+			column.mStrings[i] = value.cast<std::wstring>();
+		}
+	}
+
+	column.mStringPtrs = pcu::toPtrVec(column.mStrings);
+	return true;
+}
+
+// the column type required by a declared rule attribute type, false if the array type cannot be converted
+bool getColumnType(prt::AnnotationArgumentType attributeType, char kind, AttributeColumn::Type& columnType) {
+	switch (attributeType) {
+		case prt::AAT_BOOL:
+		case prt::AAT_BOOL_ARRAY:
+			columnType = AttributeColumn::Type::BOOL;
+			return kind == 'b';
+		case prt::AAT_FLOAT:
+		case prt::AAT_FLOAT_ARRAY:
+			columnType = AttributeColumn::Type::FLOAT;
+			return kind == 'f' || kind == 'i' || kind == 'u';
+		case prt::AAT_INT:
+			columnType = AttributeColumn::Type::INT;
+			return kind == 'i' || kind == 'u';
+		case prt::AAT_STR:
+		case prt::AAT_STR_ARRAY:
+			columnType = AttributeColumn::Type::STRING;
+			return kind == 'U' || kind == 'O';
+		default:
+			break;
+	}
+
+	// no declared type, use the array type
+	switch (kind) {
+		case 'b':
+			columnType = AttributeColumn::Type::BOOL;
+			return true;
+		case 'i':
+		case 'u':
+			columnType = AttributeColumn::Type::INT;
+			return true;
+		case 'f':
+			columnType = AttributeColumn::Type::FLOAT;
+			return true;
+		case 'U':
+		case 'O':
+			columnType = AttributeColumn::Type::STRING;
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool isArrayType(prt::AnnotationArgumentType attributeType) {
+	return attributeType == prt::AAT_BOOL_ARRAY || attributeType == prt::AAT_FLOAT_ARRAY ||
+	       attributeType == prt::AAT_STR_ARRAY;
+}
+
+bool createAttributeColumn(const std::wstring& key, const py::handle& values,
+                           prt::AnnotationArgumentType attributeType, size_t firstRow, size_t rowCount,
+                           AttributeColumn& column) {
+	column.mKey = key;
+
+	// a list is sliced before it is converted, it would otherwise be converted as a whole for every chunk
+	py::object rowValues = py::reinterpret_borrow<py::object>(values);
+	size_t rowOffset = firstRow;
+	if (py::isinstance<py::list>(values)) {
+		if (py::len(values) < firstRow + rowCount) {
+			LOG_ERR << L"not enough values in shape attribute column " << key;
+			return false;
+		}
+		rowValues = values[py::slice(static_cast<py::ssize_t>(firstRow), static_cast<py::ssize_t>(firstRow + rowCount),
+		                             1)];
+		rowOffset = 0;
+	}
+
+	const py::array array = py::array::ensure(rowValues);
+	if (!array) {
+		PyErr_Clear();
+		LOG_ERR << L"cannot convert shape attribute column " << key << L" to an array";
+		return false;
+	}
+	if (array.ndim() < 1 || array.ndim() > 2) {
+		LOG_ERR << L"shape attribute column " << key << L" must have one or two dimensions";
+		return false;
+	}
+	if (static_cast<size_t>(array.shape(0)) < rowOffset + rowCount) {
+		LOG_ERR << L"not enough values in shape attribute column " << key;
+		return false;
+	}
+	if (attributeType != prt::AAT_UNKNOWN && isArrayType(attributeType) != (array.ndim() == 2)) {
+		LOG_ERR << L"shape attribute column " << key << L" must have "
+		        << (isArrayType(attributeType) ? L"two dimensions for an array attribute"
+		                                       : L"one dimension for a scalar attribute");
+		return false;
+	}
+	column.mWidth = (array.ndim() == 2) ? static_cast<size_t>(array.shape(1)) : 0;
+
+	if (!getColumnType(attributeType, array.dtype().kind(), column.mType)) {
+		LOG_ERR << L"unsupported value type in shape attribute column " << key;
+		return false;
+	}
+
+	// only the rows to convert are cast or decoded, slicing an array returns a view
+	const py::array rows = array[py::slice(static_cast<py::ssize_t>(rowOffset),
+	                                       static_cast<py::ssize_t>(rowOffset + rowCount), 1)];
+
+	constexpr int FLAGS = py::array::c_style | py::array::forcecast;
+	switch (column.mType) {
+		case AttributeColumn::Type::BOOL:
+			column.mArray = py::array_t<bool, FLAGS>::ensure(rows);
+			break;
+		case AttributeColumn::Type::INT:
+			column.mArray = py::array_t<int32_t, FLAGS>::ensure(rows);
+			break;
+		case AttributeColumn::Type::FLOAT:
+			column.mArray = py::array_t<double, FLAGS>::ensure(rows);
+			break;
+		case AttributeColumn::Type::STRING:
+			return decodeStringColumn(rows, column);
+	}
+
+	if (!column.mArray) {
+		PyErr_Clear();
+		LOG_ERR << L"cannot convert shape attribute column " << key;
+		return false;
+	}
+	return true;
+}
+
+bool toBool(PyObject* value, bool& result) {
+	if (!PyBool_Check(value))
+		return false;
+	result = (value == Py_True);
+	return true;
+}
+
+// ints are accepted for float attributes, bools are not
+bool toDouble(PyObject* value, double& result) {
+	if (PyBool_Check(value) || !PyNumber_Check(value))
+		return false;
+	result = PyFloat_AsDouble(value);
+	if (result == -1.0 && PyErr_Occurred()) {
+		PyErr_Clear();
+		return false;
+	}
+	return true;
+}
+
+bool toInt(PyObject* value, int32_t& result) {
+	if (PyBool_Check(value) || !PyLong_Check(value))
+		return false;
+	const long long v = PyLong_AsLongLong(value);
+	if ((v == -1 && PyErr_Occurred()) || v < std::numeric_limits<int32_t>::min() ||
+	    v > std::numeric_limits<int32_t>::max()) {
+		PyErr_Clear();
+		return false;
+	}
+	result = static_cast<int32_t>(v);
+	return true;
+}
+
+bool toStringValue(PyObject* value, std::wstring& result) {
+	if (!PyUnicode_Check(value))
+		return false;
+	result = py::handle(value).cast<std::wstring>();
+	return true;
+}
+
+template <typename T, typename F>
+bool toVector(const py::handle& value, F convert, std::vector<T>& result) {
+	if (!PyList_Check(value.ptr()))
+		return false;
+	const py::list values = py::reinterpret_borrow<py::list>(value);
+	result.resize(values.size());
+	for (size_t i = 0; i < result.size(); i++) {
+		if (!convert(PyList_GET_ITEM(values.ptr(), static_cast<Py_ssize_t>(i)), result[i]))
+			return false;
+	}
+	return true;
+}
+
+// appends a type-tagged and length-prefixed representation of a scalar or list value, false for other values
+bool appendCanonicalValue(PyObject* value, std::wstring& key) {
+	if (PyBool_Check(value)) {
+		key += (value == Py_True) ? L"b1" : L"b0";
+	}
+	else if (PyLong_Check(value)) {
+		key += L'i' + py::str(value).cast<std::wstring>() + L';';
+	}
+	else if (PyFloat_Check(value)) {
+		uint64_t bits = 0;
+		const double v = PyFloat_AS_DOUBLE(value);
+		std::memcpy(&bits, &v, sizeof(bits));
+		key += L'f' + std::to_wstring(bits) + L';';
+	}
+	else if (PyUnicode_Check(value)) {
+		const std::wstring v = py::handle(value).cast<std::wstring>();
+		key += L's' + std::to_wstring(v.size()) + L':' + v;
+	}
+	else if (PyList_Check(value)) {
+		const Py_ssize_t count = PyList_GET_SIZE(value);
+		key += L'l' + std::to_wstring(count) + L':';
+		for (Py_ssize_t i = 0; i < count; i++) {
+			if (!appendCanonicalValue(PyList_GET_ITEM(value, i), key))
+				return false;
+		}
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+template <typename T>
+const T* getRowValues(const AttributeColumn& column, size_t row) {
+	return static_cast<const T*>(column.mArray.data()) + row * std::max<size_t>(column.mWidth, 1);
+}
+
+} // namespace
+
 namespace pcu {
 
 constexpr const wchar_t* CGA_STYLE_DEFAULT = L"Default$";
@@ -142,6 +421,22 @@ std::unordered_set<std::wstring> getHiddenAttributes(const RuleFileInfoUPtr& rul
 	return hiddenVec;
 }
 
+RuleAttributeTypes getRuleAttributeTypes(const RuleFileInfoUPtr& ruleFileInfo) {
+	RuleAttributeTypes attributeTypes;
+
+	for (size_t ai = 0, numAttrs = ruleFileInfo->getNumAttributes(); ai < numAttrs; ai++) {
+		const auto attr = ruleFileInfo->getAttribute(ai);
+		if (attr->getNumParameters() > 0)
+			continue;
+		const std::wstring name = removeDefaultStyleName(attr->getName());
+		if (name != attr->getName()) // only attributes of the default style can be set without style prefix
+			attributeTypes.emplace(name, attr->getReturnType());
+		attributeTypes.emplace(attr->getName(), attr->getReturnType());
+	}
+
+	return attributeTypes;
+}
+
 std::wstring removeDefaultStyleName(const wchar_t* key) {
 	const std::wstring keyName = key;
 	if (keyName.find(CGA_STYLE_DEFAULT) == 0)
@@ -151,114 +446,275 @@ std::wstring removeDefaultStyleName(const wchar_t* key) {
 }
 
 /**
- * Helper function to convert a Python dictionary of "<key>:<value>" into a
- * prt::AttributeMap
+ * Helper function to set a Python value into a prt::AttributeMapBuilder, the PRT type is derived from the Python type
  */
-AttributeMapPtr createAttributeMapFromPythonDict(const py::dict& args, prt::AttributeMapBuilder& bld) {
-	for (auto a : args) {
-
-		const std::wstring key = a.first.cast<std::wstring>();
-
-		if (py::isinstance<py::list>(a.second.ptr())) {
-			auto li = a.second.cast<py::list>();
+void setAttributeFromPythonValue(const std::wstring& key, const py::handle& value, prt::AttributeMapBuilder& bld) {
+	if (py::isinstance<py::list>(value.ptr())) {
+		auto li = value.cast<py::list>();
 
-			if (py::isinstance<py::bool_>(li[0])) {
-				try {
-					size_t count = li.size();
-					std::unique_ptr<bool[]> v_arr(new bool[count]);
+		if (py::isinstance<py::bool_>(li[0])) {
+			try {
+				size_t count = li.size();
+				std::unique_ptr<bool[]> v_arr(new bool[count]);
 
-					for (size_t i = 0; i < count; i++) {
-						bool item = li[i].cast<bool>();
-						v_arr[i] = item;
-					}
-
-					bld.setBoolArray(key.c_str(), v_arr.get(), count);
-				}
-				catch (std::exception& e) {
-					LOG_ERR << L"cannot set bool array attribute " << key << ": " << e.what();
+				for (size_t i = 0; i < count; i++) {
+					bool item = li[i].cast<bool>();
+					v_arr[i] = item;
 				}
+
+				bld.setBoolArray(key.c_str(), v_arr.get(), count);
 			}
-			else if (py::isinstance<py::float_>(li[0])) {
-				try {
-					const size_t count = li.size();
-					std::vector<double> v_arr(count);
-					for (size_t i = 0; i < v_arr.size(); i++) {
-						double item = li[i].cast<double>();
-						v_arr[i] = item;
-					}
-
-					bld.setFloatArray(key.c_str(), v_arr.data(), v_arr.size());
-				}
-				catch (std::exception& e) {
-					LOG_ERR << L"cannot set float array attribute " << key << ": " << e.what();
-				}
+			catch (std::exception& e) {
+				LOG_ERR << L"cannot set bool array attribute " << key << ": " << e.what();
 			}
-			else if (py::isinstance<py::int_>(li[0])) {
-				try {
-					const size_t count = li.size();
-					std::vector<int32_t> v_arr(count);
-					for (size_t i = 0; i < v_arr.size(); i++) {
-						int32_t item = li[i].cast<int32_t>();
-						v_arr[i] = item;
-					}
-
-					bld.setIntArray(key.c_str(), v_arr.data(), v_arr.size());
-				}
-				catch (std::exception& e) {
-					std::wcerr << L"cannot set int array attribute " << key << ": " << e.what() << std::endl;
+		}
+		else if (py::isinstance<py::float_>(li[0])) {
+			try {
+				const size_t count = li.size();
+				std::vector<double> v_arr(count);
+				for (size_t i = 0; i < v_arr.size(); i++) {
+					double item = li[i].cast<double>();
+					v_arr[i] = item;
 				}
+
+				bld.setFloatArray(key.c_str(), v_arr.data(), v_arr.size());
+			}
+			catch (std::exception& e) {
+				LOG_ERR << L"cannot set float array attribute " << key << ": " << e.what();
 			}
-			else if (py::isinstance<py::str>(li[0])) {
+		}
+		else if (py::isinstance<py::int_>(li[0])) {
+			try {
 				const size_t count = li.size();
-				std::vector<std::wstring> v_arr(count);
+				std::vector<int32_t> v_arr(count);
 				for (size_t i = 0; i < v_arr.size(); i++) {
-					std::wstring item = li[i].cast<std::wstring>();
+					int32_t item = li[i].cast<int32_t>();
 					v_arr[i] = item;
 				}
 
-				const auto v_arr_ptrs = toPtrVec(v_arr); // setStringArray requires contiguous array
-				bld.setStringArray(key.c_str(), v_arr_ptrs.data(), v_arr_ptrs.size());
+				bld.setIntArray(key.c_str(), v_arr.data(), v_arr.size());
+			}
+			catch (std::exception& e) {
+				std::wcerr << L"cannot set int array attribute " << key << ": " << e.what() << std::endl;
+			}
+		}
+		else if (py::isinstance<py::str>(li[0])) {
+			const size_t count = li.size();
+			std::vector<std::wstring> v_arr(count);
+			for (size_t i = 0; i < v_arr.size(); i++) {
+				std::wstring item = li[i].cast<std::wstring>();
+				v_arr[i] = item;
+			}
+
+			const auto v_arr_ptrs = toPtrVec(v_arr); // setStringArray requires contiguous array
+			bld.setStringArray(key.c_str(), v_arr_ptrs.data(), v_arr_ptrs.size());
+		}
+		else
+			LOG_WRN << "Encountered unknown array type for key " << key;
+	}
+	else {
+		if (py::isinstance<py::bool_>(value.ptr())) { // check for boolean first!!
+			try {
+				bool val = value.cast<bool>();
+				bld.setBool(key.c_str(), val);
+			}
+			catch (std::exception& e) {
+				LOG_ERR << "cannot set bool attribute " << key << ": " << e.what();
 			}
-			else
-				LOG_WRN << "Encountered unknown array type for key " << key;
 		}
-		else {
-			if (py::isinstance<py::bool_>(a.second.ptr())) { // check for boolean first!!
-				try {
-					bool val = a.second.cast<bool>();
-					bld.setBool(key.c_str(), val);
-				}
-				catch (std::exception& e) {
-					LOG_ERR << "cannot set bool attribute " << key << ": " << e.what();
-				}
+		else if (py::isinstance<py::float_>(value.ptr())) {
+			try {
+				double val = value.cast<double>();
+				bld.setFloat(key.c_str(), val);
+			}
+			catch (std::exception& e) {
+				LOG_ERR << "cannot set float attribute " << key << ": " << e.what();
+			}
+		}
+		else if (py::isinstance<py::int_>(value.ptr())) {
+			try {
+				int32_t val = value.cast<int32_t>();
+				bld.setInt(key.c_str(), val);
+			}
+			catch (std::exception& e) {
+				std::wcerr << L"cannot set int attribute " << key << ": " << e.what() << std::endl;
+			}
+		}
+		else if (py::isinstance<py::str>(value.ptr())) {
+			std::wstring val = value.cast<std::wstring>();
+			bld.setString(key.c_str(), val.c_str());
+		}
+		else
+			LOG_WRN << "Encountered unknown scalar type for key " << key;
+	}
+}
+
+/**
+ * Helper function to convert a Python dictionary of "<key>:<value>" into a
+ * prt::AttributeMap
+ */
+AttributeMapPtr createAttributeMapFromPythonDict(const py::dict& args, prt::AttributeMapBuilder& bld) {
+	for (auto a : args) {
+		const std::wstring key = a.first.cast<std::wstring>();
+		setAttributeFromPythonValue(key, a.second, bld);
+	}
+	return AttributeMapPtr{bld.createAttributeMapAndReset()};
+}
+
+/**
+ * Creates a key which is equal for dictionaries with equal keys and values, independent of the key order. Returns
+ * false if the dictionary contains values which cannot be represented in the key.
+ */
+bool getCanonicalKey(const py::dict& args, std::wstring& key) {
+	std::vector<std::pair<std::wstring, std::wstring>> items;
+	items.reserve(args.size());
+	for (auto a : args) {
+		if (!PyUnicode_Check(a.first.ptr()))
+			return false;
+		std::wstring value;
+		if (!appendCanonicalValue(a.second.ptr(), value))
+			return false;
+		items.emplace_back(a.first.cast<std::wstring>(), std::move(value));
+	}
+	std::sort(items.begin(), items.end());
+
+	key.clear();
+	for (const auto& [name, value] : items)
+		key += std::to_wstring(name.size()) + L':' + name + value;
+	return true;
+}
+
+/**
+ * Helper function to set a Python value into a prt::AttributeMapBuilder according to the declared type of the rule
+ * attribute (ints are accepted for floats). Values of keys without declared type are set according to their Python type.
+ * Returns false if the value does not match the declared type.
+ */
+bool setTypedAttributeFromPythonValue(const std::wstring& key, prt::AnnotationArgumentType type,
+                                      const py::handle& value, prt::AttributeMapBuilder& bld) {
+	switch (type) {
+		case prt::AAT_BOOL: {
+			bool v = false;
+			if (!toBool(value.ptr(), v))
+				return false;
+			bld.setBool(key.c_str(), v);
+			return true;
+		}
+		case prt::AAT_FLOAT: {
+			double v = 0.0;
+			if (!toDouble(value.ptr(), v))
+				return false;
+			bld.setFloat(key.c_str(), v);
+			return true;
+		}
+		case prt::AAT_INT: {
+			int32_t v = 0;
+			if (!toInt(value.ptr(), v))
+				return false;
+			bld.setInt(key.c_str(), v);
+			return true;
+		}
+		case prt::AAT_STR: {
+			std::wstring v;
+			if (!toStringValue(value.ptr(), v))
+				return false;
+			bld.setString(key.c_str(), v.c_str());
+			return true;
+		}
+		case prt::AAT_BOOL_ARRAY: {
+			if (!PyList_Check(value.ptr()))
+				return false;
+			const size_t count = static_cast<size_t>(PyList_GET_SIZE(value.ptr()));
+			std::unique_ptr<bool[]> v_arr(new bool[count]);
+			for (size_t i = 0; i < count; i++) {
+				if (!toBool(PyList_GET_ITEM(value.ptr(), static_cast<Py_ssize_t>(i)), v_arr[i]))
+					return false;
 			}
-			else if (py::isinstance<py::float_>(a.second.ptr())) {
-				try {
-					double val = a.second.cast<double>();
-					bld.setFloat(key.c_str(), val);
+			bld.setBoolArray(key.c_str(), v_arr.get(), count);
+			return true;
+		}
+		case prt::AAT_FLOAT_ARRAY: {
+			std::vector<double> v_arr;
+			if (!toVector(value, toDouble, v_arr))
+				return false;
+			bld.setFloatArray(key.c_str(), v_arr.data(), v_arr.size());
+			return true;
+		}
+		case prt::AAT_STR_ARRAY: {
+			std::vector<std::wstring> v_arr;
+			if (!toVector(value, toStringValue, v_arr))
+				return false;
+			const auto v_arr_ptrs = toPtrVec(v_arr);
+			bld.setStringArray(key.c_str(), v_arr_ptrs.data(), v_arr_ptrs.size());
+			return true;
+		}
+		default:
+			setAttributeFromPythonValue(key, value, bld);
+			return true;
+	}
+}
+
+/**
+ * Converts a dictionary of shape attribute columns (NumPy arrays or lists, one value or one row of values per initial
+ * shape) to one prt::AttributeMap per row in [firstRow, firstRow + rowCount). The type of a column is determined once
+ * from the declared rule attribute type or its array type, the rows are then converted without any Python calls.
+ */
+bool createAttributeMapsFromPythonColumns(const py::dict& columns, const RuleAttributeTypes& attributeTypes,
+                                          size_t firstRow, size_t rowCount,
+                                          std::vector<AttributeMapPtr>& attributeMaps) {
+	std::vector<AttributeColumn> attributeColumns(columns.size());
+	size_t columnIdx = 0;
+	for (auto column : columns) {
+		const std::wstring key = column.first.cast<std::wstring>();
+		const auto attributeType = attributeTypes.find(key);
+		if (!createAttributeColumn(key, column.second,
+		                           (attributeType != attributeTypes.end()) ? attributeType->second : prt::AAT_UNKNOWN,
+		                           firstRow, rowCount, attributeColumns[columnIdx++]))
+			return false;
+	}
+
+	const AttributeMapBuilderPtr bld{prt::AttributeMapBuilder::create()};
+	attributeMaps.resize(rowCount);
+	for (size_t r = 0; r < rowCount; r++) {
+		for (const AttributeColumn& column : attributeColumns) {
+			const wchar_t* key = column.mKey.c_str();
+			switch (column.mType) {
+				case AttributeColumn::Type::BOOL: {
+					const bool* values = getRowValues<bool>(column, r);
+					if (column.mWidth > 0)
+						bld->setBoolArray(key, values, column.mWidth);
+					else
+						bld->setBool(key, values[0]);
+					break;
 				}
-				catch (std::exception& e) {
-					LOG_ERR << "cannot set float attribute " << key << ": " << e.what();
+				case AttributeColumn::Type::INT: {
+					const int32_t* values = getRowValues<int32_t>(column, r);
+					if (column.mWidth > 0)
+						bld->setIntArray(key, values, column.mWidth);
+					else
+						bld->setInt(key, values[0]);
+					break;
 				}
-			}
-			else if (py::isinstance<py::int_>(a.second.ptr())) {
-				try {
-					int32_t val = a.second.cast<int32_t>();
-					bld.setInt(key.c_str(), val);
+				case AttributeColumn::Type::FLOAT: {
+					const double* values = getRowValues<double>(column, r);
+					if (column.mWidth > 0)
+						bld->setFloatArray(key, values, column.mWidth);
+					else
+						bld->setFloat(key, values[0]);
+					break;
 				}
-				catch (std::exception& e) {
-					std::wcerr << L"cannot set int attribute " << key << ": " << e.what() << std::endl;
+				case AttributeColumn::Type::STRING: {
+					const wchar_t* const* values = column.mStringPtrs.data() + r * std::max<size_t>(column.mWidth, 1);
+					if (column.mWidth > 0)
+						bld->setStringArray(key, values, column.mWidth);
+					else
+						bld->setString(key, values[0]);
+					break;
 				}
 			}
-			else if (py::isinstance<py::str>(a.second.ptr())) {
-				std::wstring val = a.second.cast<std::wstring>();
-				bld.setString(key.c_str(), val.c_str());
-			}
-			else
-				LOG_WRN << "Encountered unknown scalar type for key " << key;
 		}
+		attributeMaps[r].reset(bld->createAttributeMapAndReset());
 	}
-	return AttributeMapPtr{bld.createAttributeMap()};
+	return true;
 }
 
 /**
@@ -293,6 +749,10 @@ std::string toUTF8FromOSNarrow(const std::string& osString) {
 	return callAPI<wchar_t, char>(prt::StringUtils::toUTF8FromUTF16, utf16String);
 }
 
+std::string toUTF8FromUTF16(const std::wstring& utf16String) {
+	return callAPI<wchar_t, char>(prt::StringUtils::toUTF8FromUTF16, utf16String);
+}
+
 std::string percentEncode(const std::string& utf8String) {
 	return callAPI<char, char>(prt::StringUtils::percentEncode, utf8String);
 }
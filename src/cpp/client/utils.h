@@ -41,9 +41,17 @@ bool getResolveMap(const std::filesystem::path& rulePackagePath, ResolveMapPtr*
 std::wstring getRuleFileEntry(const prt::ResolveMap* resolveMap);
 std::wstring detectStartRule(const RuleFileInfoUPtr& ruleFileInfo);
 std::unordered_set<std::wstring> getHiddenAttributes(const RuleFileInfoUPtr& ruleFileInfo);
+RuleAttributeTypes getRuleAttributeTypes(const RuleFileInfoUPtr& ruleFileInfo);
 std::wstring removeDefaultStyleName(const wchar_t* key);
 
+void setAttributeFromPythonValue(const std::wstring& key, const py::handle& value, prt::AttributeMapBuilder& bld);
+bool setTypedAttributeFromPythonValue(const std::wstring& key, prt::AnnotationArgumentType type,
+                                      const py::handle& value, prt::AttributeMapBuilder& bld);
 AttributeMapPtr createAttributeMapFromPythonDict(const py::dict& args, prt::AttributeMapBuilder& bld);
+bool getCanonicalKey(const py::dict& args, std::wstring& key);
+bool createAttributeMapsFromPythonColumns(const py::dict& columns, const RuleAttributeTypes& attributeTypes,
+                                          size_t firstRow, size_t rowCount,
+                                          std::vector<AttributeMapPtr>& attributeMaps);
 AttributeMapPtr createValidatedOptions(const std::wstring& encID, const AttributeMapPtr& unvalidatedOptions);
 
 template <typename C>
@@ -60,10 +68,18 @@ std::vector<const C*> toPtrVec(const std::vector<std::unique_ptr<C, D>>& sv) {
 	return pv;
 }
 
+template <typename C>
+std::vector<const C*> toPtrVec(const std::vector<std::shared_ptr<C>>& sv) {
+	std::vector<const C*> pv(sv.size());
+	std::transform(sv.begin(), sv.end(), pv.begin(), [](const std::shared_ptr<C>& s) { return s.get(); });
+	return pv;
+}
+
 std::string toOSNarrowFromUTF16(const std::wstring& osWString);
 std::wstring toUTF16FromOSNarrow(const std::string& osString);
 std::wstring toUTF16FromUTF8(const std::string& utf8String);
 std::string toUTF8FromOSNarrow(const std::string& osString);
+std::string toUTF8FromUTF16(const std::wstring& utf16String);
 
 using URI = std::string;
 URI toFileURI(const std::string& p);
@@ -0,0 +1,275 @@
+/**
+ * PyPRT - Python Bindings for the Procedural Runtime (PRT) of CityEngine
+ *
+ * Copyright (c) 2012-2026 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * A copy of the license is available in the repository's LICENSE file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * Compact geometry buffer, written by the PyEncoder and read by the Python client. All values are little-endian,
+ * independent of the byte order of the host:
+ *
+ *   char[4]     magic "PCG1"
+ *   uint8       vertex bits (16 or 32), the vertices are quantized inside the bounding box
+ *   uint8       index bits (16 if the vertex count allows, else 32)
+ *   uint16      reserved
+ *   uint32      vertex count, index count, face count
+ *   double[3]   bounding box minimum
+ *   double[3]   quantization step, vertex = minimum + step * quantized vertex
+ *   uint[3 * n] quantized vertices
+ *   uint[n]     delta-encoded indices (difference to the previous index, modulo 2^index bits)
+ *   varint[n]   vertex count per face (LEB128)
+ */
+namespace compact {
+
+constexpr char MAGIC[4] = {'P', 'C', 'G', '1'};
+constexpr size_t HEADER_SIZE = 4 + 4 + 3 * sizeof(uint32_t) + 6 * sizeof(double);
+
+struct Geometry {
+	std::vector<double> mVertexCoords;
+	std::vector<uint32_t> mFaceIndices;
+	std::vector<uint32_t> mFaceCounts;
+};
+
+namespace detail {
+
+template <size_t N>
+struct UnsignedBits;
+template <>
+struct UnsignedBits<1> {
+	using Type = uint8_t;
+};
+template <>
+struct UnsignedBits<2> {
+	using Type = uint16_t;
+};
+template <>
+struct UnsignedBits<4> {
+	using Type = uint32_t;
+};
+template <>
+struct UnsignedBits<8> {
+	using Type = uint64_t;
+};
+
+// least significant byte first
+template <typename T>
+void write(std::vector<uint8_t>& buffer, size_t& pos, T value) {
+	typename UnsignedBits<sizeof(T)>::Type bits = 0;
+	std::memcpy(&bits, &value, sizeof(T));
+	for (size_t b = 0; b < sizeof(T); b++)
+		buffer[pos++] = static_cast<uint8_t>(bits >> (8 * b));
+}
+
+template <typename T>
+bool read(const uint8_t* data, size_t size, size_t& pos, T& value) {
+	using Bits = typename UnsignedBits<sizeof(T)>::Type;
+	if (size - pos < sizeof(T))
+		return false;
+	Bits bits = 0;
+	for (size_t b = 0; b < sizeof(T); b++)
+		bits = static_cast<Bits>(bits | static_cast<Bits>(static_cast<Bits>(data[pos++]) << (8 * b)));
+	std::memcpy(&value, &bits, sizeof(T));
+	return true;
+}
+
+template <typename T>
+void writeVertices(const std::vector<double>& vertexCoords, const std::array<double, 3>& minimum,
+                   const std::array<double, 3>& step, std::vector<uint8_t>& buffer, size_t& pos) {
+	for (size_t i = 0; i < vertexCoords.size(); i++) {
+		const size_t c = i % 3;
+		const double q = (step[c] > 0.0) ? std::round((vertexCoords[i] - minimum[c]) / step[c]) : 0.0;
+		write<T>(buffer, pos, static_cast<T>(q));
+	}
+}
+
+template <typename T>
+void writeIndices(const std::vector<uint32_t>& faceIndices, std::vector<uint8_t>& buffer, size_t& pos) {
+	T previous = 0;
+	for (const uint32_t index : faceIndices) {
+		write<T>(buffer, pos, static_cast<T>(static_cast<T>(index) - previous));
+		previous = static_cast<T>(index);
+	}
+}
+
+template <typename T>
+bool readVertices(const uint8_t* data, size_t size, size_t& pos, const std::array<double, 3>& minimum,
+                  const std::array<double, 3>& step, std::vector<double>& vertexCoords) {
+	for (size_t i = 0; i < vertexCoords.size(); i++) {
+		T q = 0;
+		if (!read<T>(data, size, pos, q))
+			return false;
+		vertexCoords[i] = minimum[i % 3] + step[i % 3] * static_cast<double>(q);
+	}
+	return true;
+}
+
+template <typename T>
+bool readIndices(const uint8_t* data, size_t size, size_t& pos, std::vector<uint32_t>& faceIndices) {
+	T index = 0;
+	for (uint32_t& faceIndex : faceIndices) {
+		T delta = 0;
+		if (!read<T>(data, size, pos, delta))
+			return false;
+		index = static_cast<T>(index + delta);
+		faceIndex = index;
+	}
+	return true;
+}
+
+} // namespace detail
+
+// vertexBits is 16 or 32, the PyEncoder rejects other values
+inline std::vector<uint8_t> encode(const std::vector<double>& vertexCoords, const std::vector<uint32_t>& faceIndices,
+                                   const std::vector<uint32_t>& faceCounts, uint8_t vertexBits) {
+	vertexBits = (vertexBits == 32) ? 32 : 16;
+	const size_t vertexCount = vertexCoords.size() / 3;
+	const uint8_t indexBits = (vertexCount <= 0x10000) ? 16 : 32;
+
+	std::array<double, 3> minimum{};
+	std::array<double, 3> maximum{};
+	if (vertexCount > 0) {
+		std::copy(vertexCoords.begin(), vertexCoords.begin() + 3, minimum.begin());
+		maximum = minimum;
+		for (size_t i = 3; i < vertexCount * 3; i++) {
+			minimum[i % 3] = std::min(minimum[i % 3], vertexCoords[i]);
+			maximum[i % 3] = std::max(maximum[i % 3], vertexCoords[i]);
+		}
+	}
+	const double maxQuantized = (vertexBits == 32) ? 4294967295.0 : 65535.0;
+	std::array<double, 3> step{};
+	for (size_t c = 0; c < 3; c++)
+		step[c] = (maximum[c] - minimum[c]) / maxQuantized;
+
+	size_t faceCountsSize = 0;
+	for (uint32_t count : faceCounts) {
+		do {
+			faceCountsSize++;
+			count >>= 7;
+		} while (count != 0);
+	}
+
+	std::vector<uint8_t> buffer(HEADER_SIZE + vertexCount * 3 * (vertexBits / 8) +
+	                            faceIndices.size() * (indexBits / 8) + faceCountsSize);
+	size_t pos = 0;
+	for (const char m : MAGIC)
+		detail::write<char>(buffer, pos, m);
+	detail::write<uint8_t>(buffer, pos, vertexBits);
+	detail::write<uint8_t>(buffer, pos, indexBits);
+	detail::write<uint16_t>(buffer, pos, 0);
+	detail::write<uint32_t>(buffer, pos, static_cast<uint32_t>(vertexCount));
+	detail::write<uint32_t>(buffer, pos, static_cast<uint32_t>(faceIndices.size()));
+	detail::write<uint32_t>(buffer, pos, static_cast<uint32_t>(faceCounts.size()));
+	for (const double m : minimum)
+		detail::write<double>(buffer, pos, m);
+	for (const double s : step)
+		detail::write<double>(buffer, pos, s);
+
+	if (vertexBits == 32)
+		detail::writeVertices<uint32_t>(vertexCoords, minimum, step, buffer, pos);
+	else
+		detail::writeVertices<uint16_t>(vertexCoords, minimum, step, buffer, pos);
+
+	if (indexBits == 32)
+		detail::writeIndices<uint32_t>(faceIndices, buffer, pos);
+	else
+		detail::writeIndices<uint16_t>(faceIndices, buffer, pos);
+
+	for (uint32_t count : faceCounts) {
+		while (count >= 0x80) {
+			buffer[pos++] = static_cast<uint8_t>(count | 0x80);
+			count >>= 7;
+		}
+		buffer[pos++] = static_cast<uint8_t>(count);
+	}
+	return buffer;
+}
+
+// false if the buffer is not a valid compact geometry buffer
+inline bool decode(const uint8_t* data, size_t size, Geometry& geometry) {
+	size_t pos = 0;
+	char magic[4];
+	for (char& m : magic) {
+		if (!detail::read<char>(data, size, pos, m))
+			return false;
+	}
+	if (!std::equal(std::begin(magic), std::end(magic), std::begin(MAGIC)))
+		return false;
+
+	uint8_t vertexBits = 0;
+	uint8_t indexBits = 0;
+	uint16_t reserved = 0;
+	uint32_t vertexCount = 0;
+	uint32_t indexCount = 0;
+	uint32_t faceCount = 0;
+	std::array<double, 3> minimum{};
+	std::array<double, 3> step{};
+	if (!detail::read(data, size, pos, vertexBits) || !detail::read(data, size, pos, indexBits) ||
+	    !detail::read(data, size, pos, reserved) || !detail::read(data, size, pos, vertexCount) ||
+	    !detail::read(data, size, pos, indexCount) || !detail::read(data, size, pos, faceCount))
+		return false;
+	for (double& m : minimum) {
+		if (!detail::read(data, size, pos, m))
+			return false;
+	}
+	for (double& s : step) {
+		if (!detail::read(data, size, pos, s))
+			return false;
+	}
+	if ((vertexBits != 16 && vertexBits != 32) || (indexBits != 16 && indexBits != 32))
+		return false;
+	if ((size - pos) / (vertexBits / 8) / 3 < vertexCount)
+		return false; // checked before allocating
+
+	geometry.mVertexCoords.resize(static_cast<size_t>(vertexCount) * 3);
+	const bool verticesRead =
+	        (vertexBits == 32)
+	                ? detail::readVertices<uint32_t>(data, size, pos, minimum, step, geometry.mVertexCoords)
+	                : detail::readVertices<uint16_t>(data, size, pos, minimum, step, geometry.mVertexCoords);
+	if (!verticesRead || (size - pos) / (indexBits / 8) < indexCount)
+		return false;
+
+	geometry.mFaceIndices.resize(indexCount);
+	const bool indicesRead = (indexBits == 32)
+	                                 ? detail::readIndices<uint32_t>(data, size, pos, geometry.mFaceIndices)
+	                                 : detail::readIndices<uint16_t>(data, size, pos, geometry.mFaceIndices);
+	if (!indicesRead || size - pos < faceCount)
+		return false;
+
+	geometry.mFaceCounts.resize(faceCount);
+	for (uint32_t& count : geometry.mFaceCounts) {
+		count = 0;
+		for (int shift = 0;; shift += 7) {
+			if (pos >= size || shift > 28)
+				return false;
+			const uint8_t byte = data[pos++];
+			count |= static_cast<uint32_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+				break;
+		}
+	}
+	return pos == size;
+}
+
+} // namespace compact
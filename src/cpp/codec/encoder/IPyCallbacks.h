@@ -22,13 +22,47 @@
 #include "codec.h"
 #include "prt/Callbacks.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// geometric statistics of a generated model, the y axis points up
+struct GeometrySummary {
+	double mFootprintArea = 0.0; // area of the initial shape projected onto the ground plane
+	double mSurfaceArea = 0.0;
+	double mVolume = 0.0; // only meaningful for closed meshes
+	double mHeight = 0.0;
+	double mMin[3] = {0.0, 0.0, 0.0};
+	double mMax[3] = {0.0, 0.0, 0.0};
+};
+
 class PYENC_EXPORTS_API IPyCallbacks : public prt::Callbacks {
 public:
 	virtual ~IPyCallbacks() override = default;
 
-	virtual void addGeometry(const size_t initialShapeIndex, const double* vertexCoords, const size_t vextexCoordsCount,
-	                         const uint32_t* faceIndices, const size_t faceIndicesCount, const uint32_t* faceCounts,
-	                         const size_t faceCountsCount) = 0;
+	// the buffers are handed over, the face indices refer to the vertex coordinates passed in the same call
+	virtual void addGeometry(const size_t initialShapeIndex, std::vector<double>&& vertexCoords,
+	                         std::vector<uint32_t>&& faceIndices, std::vector<uint32_t>&& faceCounts) = 0;
+	// float32 output: the vertex coordinates are relative to the origin (3 doubles)
+	virtual void addLocalGeometry(const size_t initialShapeIndex, const double* origin,
+	                              std::vector<float>&& vertexCoords, std::vector<uint32_t>&& faceIndices,
+	                              std::vector<uint32_t>&& faceCounts) = 0;
+	virtual void addSummary(const size_t initialShapeIndex, const GeometrySummary& summary) = 0;
+
+	// one leaf shape ID per face of the geometry, the IDs index into the shape names
+	virtual void addFaceShapeIds(const size_t initialShapeIndex, std::vector<uint32_t>&& faceShapeIds,
+	                             std::vector<std::wstring>&& shapeNames) = 0;
+
+	// compact output: the geometry encoded with compact::encode()
+	virtual void addCompactGeometry(const size_t initialShapeIndex, std::vector<uint8_t>&& buffer) = 0;
+
+	// instancing: returns the ID of the prototype, the IDs are handed out by the callbacks object because PRT may run
+	// several encoder instances at the same time; a mesh identical to an earlier prototype gets the earlier ID
+	virtual uint32_t addPrototype(std::vector<double>&& vertexCoords, std::vector<uint32_t>&& faceIndices,
+	                              std::vector<uint32_t>&& faceCounts) = 0;
+	// the transformation is a column-major 4x4 matrix
+	virtual void addInstance(const size_t initialShapeIndex, const uint32_t prototypeId,
+	                         const double* transformation) = 0;
 
 	virtual void addReports(const size_t initialShapeIndex, const wchar_t** stringReportKeys,
 	                        const wchar_t** stringReportValues, size_t stringReportCount,
@@ -18,6 +18,7 @@
  */
 
 #include "PyEncoder.h"
+#include "CompactGeometry.h"
 #include "IPyCallbacks.h"
 
 #include "prtx/Attributable.h"
@@ -32,10 +33,15 @@
 #include "prtx/ShapeIterator.h"
 #include "prtx/prtx.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace {
@@ -46,11 +52,47 @@ const std::wstring ENCFILE_EXT = L".txt";
 const wchar_t* EO_TRIANGULATE = L"triangulate";
 const wchar_t* EO_EMIT_REPORT = L"emitReport";
 const wchar_t* EO_EMIT_GEOMETRY = L"emitGeometry";
+const wchar_t* EO_MERGE_VERTICES = L"mergeVertices";
+const wchar_t* EO_MERGE_TOLERANCE = L"mergeTolerance";
+const wchar_t* EO_INSTANCING = L"instancing";
+const wchar_t* EO_FLOAT32_VERTICES = L"float32Vertices";
+const wchar_t* EO_LOCAL_ORIGIN = L"localOrigin";
+const wchar_t* EO_COMPACT_GEOMETRY = L"compactGeometry";
+const wchar_t* EO_QUANTIZATION_BITS = L"quantizationBits";
+const wchar_t* EO_EMIT_SUMMARY = L"emitSummary";
+const wchar_t* EO_EMIT_FACE_SHAPE_IDS = L"emitFaceShapeIds";
+
+using FinalizedInstanceIterator = std::vector<prtx::EncodePreparator::FinalizedInstance>::const_iterator;
 
 IPyCallbacks* getPyCallbacks(prt::Callbacks* cb) {
 	return dynamic_cast<IPyCallbacks*>(cb);
 }
 
+/**
+ * Reject option values the encoder cannot honor instead of silently replacing them.
+ */
+void validateOptions(const prt::AttributeMap& options) {
+	const int32_t quantizationBits = options.getInt(EO_QUANTIZATION_BITS);
+	if (quantizationBits != 16 && quantizationBits != 32) {
+		const std::wstring msg =
+		        L"PyEncoder: 'quantizationBits' must be 16 or 32, got " + std::to_wstring(quantizationBits);
+		prt::log(msg.c_str(), prt::LOG_ERROR);
+		throw prtx::StatusException(prt::STATUS_ILLEGAL_VALUE);
+	}
+
+	const double mergeTolerance = options.getFloat(EO_MERGE_TOLERANCE);
+	if (!(mergeTolerance >= 0.0)) { // also catches NaN
+		const std::wstring msg =
+		        L"PyEncoder: 'mergeTolerance' must be a non-negative number, got " + std::to_wstring(mergeTolerance);
+		prt::log(msg.c_str(), prt::LOG_ERROR);
+		throw prtx::StatusException(prt::STATUS_ILLEGAL_VALUE);
+	}
+
+	// compactGeometry takes precedence, see processGeometries
+	if (options.getBool(EO_COMPACT_GEOMETRY) && options.getBool(EO_FLOAT32_VERTICES))
+		prt::log(L"PyEncoder: 'float32Vertices' is ignored because 'compactGeometry' is set", prt::LOG_WARNING);
+}
+
 /**
  * Manage reports collection.
  */
@@ -99,38 +141,260 @@ void processReports(prtx::GenerateContext& context, size_t initialShapeIndex, IP
 }
 
 /*
- * Manage geometries collection.
+ * Assembles the meshes of the instances into one set of buffers.
  */
-void processGeometries(std::vector<prtx::EncodePreparator::FinalizedInstance>& instances, IPyCallbacks* cb) {
+void assembleGeometry(FinalizedInstanceIterator first, FinalizedInstanceIterator last,
+                      std::vector<double>& vertexCoords, std::vector<uint32_t>& faceIndices,
+                      std::vector<uint32_t>& faceCounts) {
+	// first pass: sizes of the buffers
+	size_t vertexCoordsCount = 0;
+	size_t faceIndicesCount = 0;
+	size_t faceCountsCount = 0;
+	for (auto instance = first; instance != last; ++instance) {
+		for (const auto& mesh : instance->getGeometry()->getMeshes()) {
+			vertexCoordsCount += mesh->getVertexCoords().size();
+			faceCountsCount += mesh->getFaceCount();
+			for (uint32_t fi = 0; fi < mesh->getFaceCount(); ++fi)
+				faceIndicesCount += mesh->getFaceVertexCount(fi);
+		}
+	}
+
+	// second pass: fill the pre-sized buffers
+	vertexCoords.resize(vertexCoordsCount);
+	faceIndices.resize(faceIndicesCount);
+	faceCounts.resize(faceCountsCount);
+
+	double* vertexCoordsOut = vertexCoords.data();
+	uint32_t* faceIndicesOut = faceIndices.data();
+	uint32_t* faceCountsOut = faceCounts.data();
 	uint32_t vertexIndexBase = 0;
+	for (auto instance = first; instance != last; ++instance) {
+		for (const auto& mesh : instance->getGeometry()->getMeshes()) {
+			const prtx::DoubleVector& verts = mesh->getVertexCoords();
+			vertexCoordsOut = std::copy(verts.begin(), verts.end(), vertexCoordsOut);
 
-	std::vector<double> vertexCoords;
-	std::vector<uint32_t> faceIndices;
-	std::vector<uint32_t> faceCounts;
+			for (uint32_t fi = 0; fi < mesh->getFaceCount(); ++fi) {
+				const uint32_t* vtxIdx = mesh->getFaceVertexIndices(fi);
+				const uint32_t vtxCnt = mesh->getFaceVertexCount(fi);
+				*faceCountsOut++ = vtxCnt;
+				for (uint32_t vi = 0; vi < vtxCnt; vi++)
+					faceIndicesOut[vi] = vtxIdx[vi] + vertexIndexBase;
+				faceIndicesOut += vtxCnt;
+			}
+			vertexIndexBase += static_cast<uint32_t>(verts.size() / 3);
+		}
+	}
+}
 
-	for (const auto& instance : instances) {
-		const prtx::MeshPtrVector& meshes = instance.getGeometry()->getMeshes();
+/*
+ * Float32 output: the vertices are relative to the given origin or, without origin, to the center of the bounding box
+ * of each initial shape's geometry. Keeps float precision for large (e.g. georeferenced) coordinates.
+ * Compact output: quantized vertices and delta-encoded indices in one buffer, see CompactGeometry.h.
+ */
+struct GeometryOutput {
+	bool mFloat32 = false;
+	bool mFixedOrigin = false;
+	std::array<double, 3> mOrigin{};
+	bool mCompact = false;
+	uint8_t mQuantizationBits = 16;
+};
+
+std::array<double, 3> getBoundingBoxCenter(const std::vector<double>& vertexCoords) {
+	if (vertexCoords.size() < 3)
+		return {};
+
+	std::array<double, 3> minCorner{vertexCoords[0], vertexCoords[1], vertexCoords[2]};
+	std::array<double, 3> maxCorner = minCorner;
+	for (size_t i = 3; i + 2 < vertexCoords.size(); i += 3) {
+		for (size_t c = 0; c < 3; c++) {
+			minCorner[c] = std::min(minCorner[c], vertexCoords[i + c]);
+			maxCorner[c] = std::max(maxCorner[c], vertexCoords[i + c]);
+		}
+	}
+	return {(minCorner[0] + maxCorner[0]) / 2.0, (minCorner[1] + maxCorner[1]) / 2.0,
+	        (minCorner[2] + maxCorner[2]) / 2.0};
+}
 
-		vertexCoords.clear();
-		faceIndices.clear();
-		faceCounts.clear();
+std::vector<float> toLocalCoordinates(const std::vector<double>& vertexCoords, const std::array<double, 3>& origin) {
+	std::vector<float> localCoords(vertexCoords.size());
+	for (size_t i = 0; i + 2 < vertexCoords.size(); i += 3) {
+		localCoords[i] = static_cast<float>(vertexCoords[i] - origin[0]);
+		localCoords[i + 1] = static_cast<float>(vertexCoords[i + 1] - origin[1]);
+		localCoords[i + 2] = static_cast<float>(vertexCoords[i + 2] - origin[2]);
+	}
+	return localCoords;
+}
 
-		for (const auto& mesh : meshes) {
-			const prtx::DoubleVector& verts = mesh->getVertexCoords();
-			vertexCoords.insert(vertexCoords.end(), verts.begin(), verts.end());
+/*
+ * Manage geometries collection.
+ */
+void processGeometries(const std::vector<prtx::EncodePreparator::FinalizedInstance>& instances,
+                       const GeometryOutput& output, IPyCallbacks* cb) {
+	auto first = instances.begin();
+	while (first != instances.end()) {
+		// the instances of one initial shape are assembled into one set of buffers
+		const size_t initialShapeIndex = first->getInitialShapeIndex();
+		const auto last = std::find_if(first, instances.end(), [initialShapeIndex](const auto& instance) {
+			return instance.getInitialShapeIndex() != initialShapeIndex;
+		});
+
+		std::vector<double> vertexCoords;
+		std::vector<uint32_t> faceIndices;
+		std::vector<uint32_t> faceCounts;
+		assembleGeometry(first, last, vertexCoords, faceIndices, faceCounts);
+
+		if (output.mCompact) {
+			cb->addCompactGeometry(initialShapeIndex, compact::encode(vertexCoords, faceIndices, faceCounts,
+			                                                          output.mQuantizationBits));
+		}
+		else if (output.mFloat32) {
+			const std::array<double, 3> origin =
+			        output.mFixedOrigin ? output.mOrigin : getBoundingBoxCenter(vertexCoords);
+			cb->addLocalGeometry(initialShapeIndex, origin.data(), toLocalCoordinates(vertexCoords, origin),
+			                     std::move(faceIndices), std::move(faceCounts));
+		}
+		else {
+			cb->addGeometry(initialShapeIndex, std::move(vertexCoords), std::move(faceIndices),
+			                std::move(faceCounts));
+		}
+		first = last;
+	}
+}
+
+double getFootprintArea(const prtx::InitialShape& initialShape) {
+	const double* vertexCoords = initialShape.getVertexCoords();
+	const uint32_t* indices = initialShape.getIndices();
+	const uint32_t* faceCounts = initialShape.getFaceCounts();
+
+	// shoelace formula in the ground plane (x, z)
+	double area = 0.0;
+	size_t firstIndex = 0;
+	for (size_t f = 0; f < initialShape.getFaceCountsCount(); f++) {
+		double faceArea = 0.0;
+		for (uint32_t i = 0; i < faceCounts[f]; i++) {
+			const double* p = vertexCoords + 3 * indices[firstIndex + i];
+			const double* q = vertexCoords + 3 * indices[firstIndex + (i + 1) % faceCounts[f]];
+			faceArea += p[0] * q[2] - q[0] * p[2];
+		}
+		area += std::abs(faceArea) / 2.0;
+		firstIndex += faceCounts[f];
+	}
+	return area;
+}
+
+/*
+ * Computes the summary of the geometry of one initial shape. The face areas use Newell's method and the volume the
+ * signed tetrahedra of a triangle fan per face, both are also correct for non-convex planar faces.
+ */
+GeometrySummary computeSummary(const std::vector<prtx::EncodePreparator::FinalizedInstance>& instances,
+                               const prtx::InitialShape& initialShape, bool instancing) {
+	GeometrySummary summary;
+	summary.mFootprintArea = getFootprintArea(initialShape);
+
+	bool hasVertices = false;
+	std::vector<double> transformedCoords;
+	for (const auto& instance : instances) {
+		// instanced meshes are in prototype coordinates
+		const prtx::DoubleVector& transformation = instance.getTransformation();
+		const bool transform = instancing && transformation.size() == 16;
+
+		for (const auto& mesh : instance.getGeometry()->getMeshes()) {
+			const prtx::DoubleVector& meshCoords = mesh->getVertexCoords();
+			const double* coords = meshCoords.data();
+			if (transform) {
+				const double* m = transformation.data();
+				transformedCoords.resize(meshCoords.size());
+				for (size_t i = 0; i + 2 < meshCoords.size(); i += 3) {
+					const double x = meshCoords[i], y = meshCoords[i + 1], z = meshCoords[i + 2];
+					transformedCoords[i] = m[0] * x + m[4] * y + m[8] * z + m[12];
+					transformedCoords[i + 1] = m[1] * x + m[5] * y + m[9] * z + m[13];
+					transformedCoords[i + 2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+				}
+				coords = transformedCoords.data();
+			}
+
+			for (size_t i = 0; i + 2 < meshCoords.size(); i += 3) {
+				for (size_t c = 0; c < 3; c++) {
+					summary.mMin[c] = hasVertices ? std::min(summary.mMin[c], coords[i + c]) : coords[i + c];
+					summary.mMax[c] = hasVertices ? std::max(summary.mMax[c], coords[i + c]) : coords[i + c];
+				}
+				hasVertices = true;
+			}
 
 			for (uint32_t fi = 0; fi < mesh->getFaceCount(); ++fi) {
 				const uint32_t* vtxIdx = mesh->getFaceVertexIndices(fi);
 				const uint32_t vtxCnt = mesh->getFaceVertexCount(fi);
-				faceCounts.push_back(vtxCnt);
-				for (uint32_t vi = 0; vi < vtxCnt; vi++)
-					faceIndices.push_back(vtxIdx[vi] + vertexIndexBase);
+				if (vtxCnt < 3)
+					continue;
+
+				double normal[3] = {0.0, 0.0, 0.0};
+				const double* p0 = coords + 3 * vtxIdx[0];
+				for (uint32_t vi = 0; vi < vtxCnt; vi++) {
+					const double* p = coords + 3 * vtxIdx[vi];
+					const double* q = coords + 3 * vtxIdx[(vi + 1) % vtxCnt];
+					normal[0] += (p[1] - q[1]) * (p[2] + q[2]);
+					normal[1] += (p[2] - q[2]) * (p[0] + q[0]);
+					normal[2] += (p[0] - q[0]) * (p[1] + q[1]);
+
+					if (vi > 0 && vi + 1 < vtxCnt) {
+						// p0 . (p x q) / 6
+						summary.mVolume += (p0[0] * (p[1] * q[2] - p[2] * q[1]) + p0[1] * (p[2] * q[0] - p[0] * q[2]) +
+						                    p0[2] * (p[0] * q[1] - p[1] * q[0])) /
+						                   6.0;
+					}
+				}
+				summary.mSurfaceArea +=
+				        std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) / 2.0;
 			}
-			vertexIndexBase += (uint32_t)verts.size() / 3;
 		}
+	}
+
+	summary.mVolume = std::abs(summary.mVolume);
+	summary.mHeight = summary.mMax[1] - summary.mMin[1];
+	return summary;
+}
+
+void fetchFinalizedInstances(prtx::EncodePreparator& encodePreparator,
+                             const prtx::EncodePreparator::PreparationFlags& flags,
+                             std::vector<prtx::EncodePreparator::FinalizedInstance>& instances) {
+	std::vector<prtx::EncodePreparator::FinalizedInstance> newInstances;
+	encodePreparator.fetchFinalizedInstances(newInstances, flags);
+	instances.insert(instances.end(), std::make_move_iterator(newInstances.begin()),
+	                 std::make_move_iterator(newInstances.end()));
+}
 
-		cb->addGeometry(instance.getInitialShapeIndex(), vertexCoords.data(), vertexCoords.size(), faceIndices.data(),
-		                faceIndices.size(), faceCounts.data(), faceCounts.size());
+// expands the leaf shape ID of each instance to its faces, in the face order of assembleGeometry()
+std::vector<uint32_t> getFaceShapeIds(const std::vector<prtx::EncodePreparator::FinalizedInstance>& instances,
+                                      const std::vector<uint32_t>& instanceShapeIds) {
+	std::vector<uint32_t> faceShapeIds;
+	for (size_t i = 0; i < instances.size(); i++) {
+		for (const auto& mesh : instances[i].getGeometry()->getMeshes())
+			faceShapeIds.insert(faceShapeIds.end(), mesh->getFaceCount(), instanceShapeIds[i]);
+	}
+	return faceShapeIds;
+}
+
+/*
+ * Manage instanced geometries collection: the prototypes are emitted on first use, the instances refer to them.
+ */
+void processInstances(const std::vector<prtx::EncodePreparator::FinalizedInstance>& instances,
+                      std::unordered_map<uint32_t, uint32_t>& prototypeIds, IPyCallbacks* cb) {
+	for (auto instance = instances.begin(); instance != instances.end(); ++instance) {
+		auto prototype = prototypeIds.find(instance->getPrototypeIndex());
+		if (prototype == prototypeIds.end()) {
+			std::vector<double> vertexCoords;
+			std::vector<uint32_t> faceIndices;
+			std::vector<uint32_t> faceCounts;
+			assembleGeometry(instance, std::next(instance), vertexCoords, faceIndices, faceCounts);
+			const uint32_t prototypeId =
+			        cb->addPrototype(std::move(vertexCoords), std::move(faceIndices), std::move(faceCounts));
+			prototype = prototypeIds.emplace(instance->getPrototypeIndex(), prototypeId).first;
+		}
+
+		const prtx::DoubleVector& transformation = instance->getTransformation();
+		if (transformation.size() != 16)
+			throw prtx::StatusException(prt::STATUS_ILLEGAL_VALUE);
+		cb->addInstance(instance->getInitialShapeIndex(), prototype->second, transformation.data());
 	}
 }
 
@@ -146,6 +410,8 @@ const std::wstring PyEncoder::DESCRIPTION = L"Encodes geometry and CGA report fo
  * material objects.
  */
 void PyEncoder::init(prtx::GenerateContext& /*context*/) {
+	validateOptions(*getOptions());
+
 	prtx::NamePreparator::NamespacePtr nsMaterials = mNamePreparator.newNamespace();
 	prtx::NamePreparator::NamespacePtr nsMeshes = mNamePreparator.newNamespace();
 	mEncodePreparator = prtx::EncodePreparator::create(true, mNamePreparator, nsMeshes, nsMaterials);
@@ -158,9 +424,10 @@ void PyEncoder::init(prtx::GenerateContext& /*context*/) {
 void PyEncoder::encode(prtx::GenerateContext& context, size_t initialShapeIndex) {
 	const prtx::EncodePreparator::PreparationFlags enc_prep_flags =
 	        prtx::EncodePreparator::PreparationFlags()
-	                .instancing(false)
+	                .instancing(getOptions()->getBool(EO_INSTANCING))
 	                .triangulate(getOptions()->getBool(EO_TRIANGULATE))
-	                .mergeVertices(false)
+	                .mergeVertices(getOptions()->getBool(EO_MERGE_VERTICES))
+	                .mergeToleranceVertices(getOptions()->getFloat(EO_MERGE_TOLERANCE))
 	                .cleanupUVs(false)
 	                .cleanupVertexNormals(false)
 	                .meshMerging(prtx::MeshMerging::ALL_OF_SAME_MATERIAL_AND_TYPE);
@@ -173,20 +440,70 @@ void PyEncoder::encode(prtx::GenerateContext& context, size_t initialShapeIndex)
 	if (getOptions()->getBool(EO_EMIT_REPORT))
 		processReports(context, initialShapeIndex, cb);
 
-	if (getOptions()->getBool(EO_EMIT_GEOMETRY)) {
+	const bool emitGeometry = getOptions()->getBool(EO_EMIT_GEOMETRY);
+	const bool emitSummary = getOptions()->getBool(EO_EMIT_SUMMARY);
+	if (emitGeometry || emitSummary) {
+		// the leaf shape IDs require the meshes of each leaf shape to stay separate
+		const bool emitFaceShapeIds = emitGeometry && getOptions()->getBool(EO_EMIT_FACE_SHAPE_IDS) &&
+		                              !getOptions()->getBool(EO_INSTANCING);
+
+		std::vector<prtx::EncodePreparator::FinalizedInstance> finalizedInstances;
+		std::vector<uint32_t> instanceShapeIds;
+		std::vector<std::wstring> shapeNames;
 		try {
 			const prtx::LeafIteratorPtr li = prtx::LeafIterator::create(context, initialShapeIndex);
 
-			for (prtx::ShapePtr shape = li->getNext(); shape.get() != nullptr; shape = li->getNext())
+			for (prtx::ShapePtr shape = li->getNext(); shape.get() != nullptr; shape = li->getNext()) {
 				mEncodePreparator->add(context.getCache(), shape, is->getAttributeMap());
+				if (emitFaceShapeIds) {
+					fetchFinalizedInstances(*mEncodePreparator, enc_prep_flags, finalizedInstances);
+					instanceShapeIds.resize(finalizedInstances.size(), static_cast<uint32_t>(shapeNames.size()));
+					shapeNames.push_back(shape->getName());
+				}
+			}
 		}
 		catch (...) {
+			finalizedInstances.clear();
+			instanceShapeIds.clear();
+			shapeNames.clear();
 			mEncodePreparator->add(context.getCache(), *is, initialShapeIndex);
+			if (emitFaceShapeIds)
+				shapeNames.push_back(is->getName());
 		}
 
-		std::vector<prtx::EncodePreparator::FinalizedInstance> finalizedInstances;
-		mEncodePreparator->fetchFinalizedInstances(finalizedInstances, enc_prep_flags);
-		processGeometries(finalizedInstances, cb);
+		fetchFinalizedInstances(*mEncodePreparator, enc_prep_flags, finalizedInstances);
+		if (emitFaceShapeIds && !shapeNames.empty()) // the fallback to the initial shape
+			instanceShapeIds.resize(finalizedInstances.size(), static_cast<uint32_t>(shapeNames.size() - 1));
+
+		if (emitSummary) {
+			cb->addSummary(initialShapeIndex,
+			               computeSummary(finalizedInstances, *is, getOptions()->getBool(EO_INSTANCING)));
+		}
+
+		if (!emitGeometry)
+			return;
+
+		if (getOptions()->getBool(EO_INSTANCING)) {
+			processInstances(finalizedInstances, mPrototypeIds, cb);
+		}
+		else {
+			GeometryOutput output;
+			output.mFloat32 = getOptions()->getBool(EO_FLOAT32_VERTICES);
+			size_t originSize = 0;
+			const double* origin = getOptions()->getFloatArray(EO_LOCAL_ORIGIN, &originSize);
+			if (origin != nullptr && originSize == 3) {
+				output.mFixedOrigin = true;
+				std::copy(origin, origin + 3, output.mOrigin.begin());
+			}
+			output.mCompact = getOptions()->getBool(EO_COMPACT_GEOMETRY);
+			output.mQuantizationBits = static_cast<uint8_t>(getOptions()->getInt(EO_QUANTIZATION_BITS)); // see init()
+			processGeometries(finalizedInstances, output, cb);
+		}
+
+		if (emitFaceShapeIds) {
+			cb->addFaceShapeIds(initialShapeIndex, getFaceShapeIds(finalizedInstances, instanceShapeIds),
+			                    std::move(shapeNames));
+		}
 	}
 }
 
@@ -214,6 +531,16 @@ PyEncoderFactory* PyEncoderFactory::createInstance() {
 	amb->setBool(EO_TRIANGULATE, prtx::PRTX_FALSE);
 	amb->setBool(EO_EMIT_REPORT, prtx::PRTX_TRUE);
 	amb->setBool(EO_EMIT_GEOMETRY, prtx::PRTX_TRUE);
+	amb->setBool(EO_MERGE_VERTICES, prtx::PRTX_FALSE);
+	amb->setFloat(EO_MERGE_TOLERANCE, 0.0);
+	amb->setBool(EO_INSTANCING, prtx::PRTX_FALSE);
+	amb->setBool(EO_FLOAT32_VERTICES, prtx::PRTX_FALSE);
+	const double noOrigin[1] = {0.0};
+	amb->setFloatArray(EO_LOCAL_ORIGIN, noOrigin, 0); // empty: origin per initial shape
+	amb->setBool(EO_COMPACT_GEOMETRY, prtx::PRTX_FALSE);
+	amb->setInt(EO_QUANTIZATION_BITS, 16);
+	amb->setBool(EO_EMIT_SUMMARY, prtx::PRTX_FALSE);
+	amb->setBool(EO_EMIT_FACE_SHAPE_IDS, prtx::PRTX_FALSE);
 	encoderInfoBuilder.setDefaultOptions(amb->createAttributeMap());
 
 	// CityEngine requires the following annotations to create an UI for an
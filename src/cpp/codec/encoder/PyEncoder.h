@@ -30,7 +30,9 @@
 #include "prt/AttributeMap.h"
 #include "prt/Callbacks.h"
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 
 // forward declare some classes to reduce header inclusion
 namespace prtx {
@@ -57,6 +59,7 @@ public:
 private:
 	prtx::DefaultNamePreparator mNamePreparator;
 	prtx::EncodePreparatorPtr mEncodePreparator;
+	std::unordered_map<uint32_t, uint32_t> mPrototypeIds; // prototype index of the preparator -> ID of the callbacks
 };
 
 class PyEncoderFactory : public prtx::EncoderFactory, public prtx::Singleton<PyEncoderFactory> {
@@ -42,3 +42,21 @@ def test_candler_rpk_attr():
                          'type': 'float'}
 
     assert inspect_dict['RearWindowWidth'] == ground_truth_dict
+
+
+def test_rpk_cache():
+    rpk = asset_file('candler.rpk')
+
+    pyprt.clear_rpk_cache()
+    stats_before = pyprt.get_rpk_cache_stats()
+    first = pyprt.get_rpk_attributes_info(rpk)
+    second = pyprt.get_rpk_attributes_info(rpk)
+    stats_after = pyprt.get_rpk_cache_stats()
+
+    assert first == second
+    assert stats_after['misses'] == stats_before['misses'] + 1
+    assert stats_after['hits'] == stats_before['hits'] + 1
+    assert stats_after['entries'] == 1
+
+    pyprt.invalidate_rpk_cache(rpk)
+    assert pyprt.get_rpk_cache_stats()['entries'] == 0
@@ -182,6 +182,21 @@ def test_cga_errors_holes():
     assert len(model[0].get_cga_errors()) == expected_error_count
 
 
+def test_lazy_python_objects():
+    rpk = asset_file('envelope2002.rpk')
+    attrs = {'report_but_not_display_green': True, 'seed': 2}
+    shape_geo_from_obj = pyprt.InitialShape(asset_file('building_parcel.obj'))
+    m = pyprt.ModelGenerator([shape_geo_from_obj])
+    model = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {'emitGeometry': False})[0]
+    report = model.get_report()
+    assert report
+    assert model.get_report() is report
+    assert model.get_attributes() is model.get_attributes()
+    assert model.get_cga_errors() is model.get_cga_errors()
+    assert model.get_cga_prints() == str(attrs['seed']) + "\n"
+    assert model.get_cga_prints() == str(attrs['seed']) + "\n"
+
+
 def test_attributesvalue_fct():
     rpk = asset_file('extrusion_rule.rpk')
     attrs = {'maxBuildingHeight': 35.0}
@@ -201,8 +216,13 @@ def test_attributesvalue_fct_arrays():
     shape_geo_from_obj = pyprt.InitialShape(asset_file('building_parcel.obj'))
     m = pyprt.ModelGenerator([shape_geo_from_obj])
     model = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {})
-    assert model[0].get_attributes() == {'arrayAttrFloat': [0.0, 1.0, 2.0], 'arrayAttrBool': [False],
-                                         'arrayAttrString': ['uhm']}
+    attributes = model[0].get_attributes()
+    assert attributes.keys() == {'arrayAttrFloat', 'arrayAttrBool', 'arrayAttrString'}
+    assert attributes['arrayAttrFloat'].dtype == 'float64'
+    assert attributes['arrayAttrFloat'].tolist() == [0.0, 1.0, 2.0]
+    assert attributes['arrayAttrBool'].dtype == 'bool'
+    assert attributes['arrayAttrBool'].tolist() == [False]
+    assert attributes['arrayAttrString'] == ['uhm']
 
 
 def test_attributesvalue_fct_arrays2d():
@@ -211,12 +231,16 @@ def test_attributesvalue_fct_arrays2d():
     shape_geo_from_obj = pyprt.InitialShape(asset_file('building_parcel.obj'))
     m = pyprt.ModelGenerator([shape_geo_from_obj])
     model = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {})
-    assert model[0].get_attributes() == {'arrayAttrBool': [[False, True], [True, False]],
-                                         'arrayAttrFloat': [[1.0, 2.0, 3.0], [4.0, 5.0, 6.0]],
-                                         'arrayAttrString': [['first', 'row'],
-                                                             ['second', 'row'],
-                                                             ['third', 'row'],
-                                                             ['fourth', 'row']]}
+    attributes = model[0].get_attributes()
+    assert attributes.keys() == {'arrayAttrBool', 'arrayAttrFloat', 'arrayAttrString'}
+    assert attributes['arrayAttrBool'].shape == (2, 2)
+    assert attributes['arrayAttrBool'].tolist() == [[False, True], [True, False]]
+    assert attributes['arrayAttrFloat'].shape == (2, 3)
+    assert attributes['arrayAttrFloat'].tolist() == [[1.0, 2.0, 3.0], [4.0, 5.0, 6.0]]
+    assert attributes['arrayAttrString'] == [['first', 'row'],
+                                             ['second', 'row'],
+                                             ['third', 'row'],
+                                             ['fourth', 'row']]
 
 
 def test_dynamic_imports():
@@ -232,3 +256,304 @@ def test_dynamic_imports():
     assert model[0].get_report() == {'myHeight_n': 1.0, 'myHeight_sum': 10.0, 'myHeight_avg': 10.0,
                                      'myHeight_min': 10.0,
                                      'myHeight_max': 10.0}
+
+
+def test_sharded_generation():
+    rpk = asset_file('extrusion_rule.rpk')
+    shapes = [pyprt.InitialShape([-10.0 - i, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0 + i])
+              for i in range(10)]
+    attrs = [{'minBuildingHeight': 10.0 + i, 'maxBuildingHeight': 10.0 + i} for i in range(10)]
+    m = pyprt.ModelGenerator(shapes)
+    models = m.generate_model(attrs, rpk, 'com.esri.pyprt.PyEncoder', {})
+    sharded_models = m.generate_model(attrs, rpk, 'com.esri.pyprt.PyEncoder', {}, numThreads=4, shardSize=3)
+    assert len(sharded_models) == len(models)
+    for model, sharded_model in zip(models, sharded_models):
+        assert sharded_model.get_initial_shape_index() == model.get_initial_shape_index()
+        assert sharded_model.get_vertices() == model.get_vertices()
+        assert sharded_model.get_report() == model.get_report()
+
+
+def test_async_generation():
+    rpk = asset_file('extrusion_rule.rpk')
+    shapes = [pyprt.InitialShape([-10.0 - i, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0 + i])
+              for i in range(3)]
+    attrs = {'minBuildingHeight': 10.0, 'maxBuildingHeight': 10.0}
+    m = pyprt.ModelGenerator(shapes)
+    models = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {})
+    future = m.generate_model_async([attrs], rpk, 'com.esri.pyprt.PyEncoder', {})
+    async_models = future.result(timeout=60)
+    assert len(async_models) == len(models)
+    for model, async_model in zip(models, async_models):
+        assert async_model.get_vertices() == model.get_vertices()
+
+
+def test_chunked_generation():
+    rpk = asset_file('extrusion_rule.rpk')
+    shapes = [pyprt.InitialShape([-10.0 - i, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0 + i])
+              for i in range(7)]
+    attrs = {'minBuildingHeight': 10.0, 'maxBuildingHeight': 10.0}
+    m = pyprt.ModelGenerator(shapes)
+    models = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {})
+    chunks = list(m.generate_iter([attrs], rpk, 'com.esri.pyprt.PyEncoder', {}, chunkSize=3))
+    assert [len(chunk) for chunk in chunks] == [3, 3, 1]
+    chunked_models = [model for chunk in chunks for model in chunk]
+    for model, chunked_model in zip(models, chunked_models):
+        assert chunked_model.get_initial_shape_index() == model.get_initial_shape_index()
+        assert chunked_model.get_vertices() == model.get_vertices()
+
+
+def test_geometry_arrays():
+    rpk = asset_file('extrusion_rule.rpk')
+    shape = pyprt.InitialShape([-10.0, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0])
+    m = pyprt.ModelGenerator([shape])
+    model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {})[0]
+    expected_vertices = model.get_vertices()
+    vertices = model.get_vertices_array()
+    assert vertices.shape == (len(expected_vertices) // 3, 3)
+    assert vertices.ravel().tolist() == expected_vertices
+    assert model.get_indices_array().tolist() == model.get_indices()
+    assert model.get_faces_array().tolist() == model.get_faces()
+    assert not vertices.flags.writeable
+    del model, m  # the array keeps the geometry buffer alive
+    assert vertices.ravel().tolist() == expected_vertices
+
+
+def test_auxiliary_outputs():
+    rpk = asset_file('envelope2002.rpk')
+    attrs = {'report_but_not_display_green': True, 'seed': 2}
+    shape_geo_from_obj = pyprt.InitialShape(asset_file('building_parcel.obj'))
+    m = pyprt.ModelGenerator([shape_geo_from_obj])
+    model = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {}, auxiliaryOutputs={'print'})[0]
+    assert model.get_cga_prints() == str(attrs['seed']) + "\n"
+    assert model.get_attributes() == {}
+    model = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {}, auxiliaryOutputs=set())[0]
+    assert model.get_cga_prints() == ''
+    assert model.get_vertices()
+    assert m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {}, auxiliaryOutputs={'unknown'}) == []
+
+
+def test_encoder_options_reuse():
+    rpk = asset_file('extrusion_rule.rpk')
+    shape = pyprt.InitialShape([-10.0, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0])
+    m = pyprt.ModelGenerator([shape])
+    for _ in range(2):
+        model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {'emitGeometry': False})[0]
+        assert model.get_vertices() == []
+        model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {})[0]
+        assert model.get_vertices()
+
+
+def test_merge_vertices():
+    rpk = asset_file('candler.rpk')
+    shape_geo_from_obj = pyprt.InitialShape(asset_file('candler_footprint.obj'))
+    m = pyprt.ModelGenerator([shape_geo_from_obj])
+    model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {'emitReport': False})[0]
+    merged_model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder',
+                                    {'emitReport': False, 'mergeVertices': True, 'mergeTolerance': 0.001})[0]
+    assert len(merged_model.get_vertices()) < len(model.get_vertices())
+    assert sum(merged_model.get_faces()) == len(merged_model.get_indices())
+    assert max(merged_model.get_indices()) < len(merged_model.get_vertices()) // 3
+    invalid_models = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder',
+                                      {'emitReport': False, 'mergeVertices': True, 'mergeTolerance': -1.0})
+    assert all(len(invalid_model.get_vertices()) == 0 for invalid_model in invalid_models)
+
+
+def test_instancing():
+    rpk = asset_file('extrusion_rule.rpk')
+    shapes = [pyprt.InitialShape([-10.0 - i, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0 + i])
+              for i in range(2)]
+    m = pyprt.ModelGenerator(shapes)
+    models = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {'instancing': True})
+    prototypes = models[0].get_prototypes()
+    assert models[1].get_prototypes() is prototypes
+    for model in models:
+        assert model.get_vertices() == []
+        instances = model.get_instances()
+        assert instances
+        for prototype_id, transformation in instances:
+            assert 0 <= prototype_id < len(prototypes)
+            assert transformation.shape == (4, 4)
+            assert prototypes.get_vertices(prototype_id)
+    flat_models = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {})
+    assert flat_models[0].get_instances() == []
+    assert flat_models[0].get_prototypes() is None
+
+
+def test_instancing_sharded():
+    rpk = asset_file('extrusion_rule.rpk')
+    shape = pyprt.InitialShape([-10.0, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0])
+    single_model = pyprt.ModelGenerator([shape]).generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder',
+                                                                {'instancing': True})[0]
+    m = pyprt.ModelGenerator([shape] * 4)
+    models = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {'instancing': True}, numThreads=2,
+                              shardSize=1)
+    prototypes = models[0].get_prototypes()
+    assert len(prototypes) == len(single_model.get_prototypes())
+    for model in models:
+        assert model.get_prototypes() is prototypes
+        assert sorted(prototype_id for prototype_id, _ in model.get_instances()) == sorted(
+            prototype_id for prototype_id, _ in single_model.get_instances())
+
+
+def test_float32_vertices():
+    rpk = asset_file('extrusion_rule.rpk')
+    offset = 2600000.0
+    shape = pyprt.InitialShape([offset - 10.0, 0.0, 10.0, offset - 10.0, 0.0, 0.0, offset + 10.0, 0.0, 0.0,
+                                offset + 10.0, 0.0, 10.0])
+    m = pyprt.ModelGenerator([shape])
+    model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {})[0]
+    local_model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {'float32Vertices': True})[0]
+    local_vertices = local_model.get_vertices_array()
+    assert local_vertices.dtype == 'float32'
+    assert local_model.get_origin()[0] == pytest.approx(offset)
+    assert (local_vertices + local_model.get_origin()).ravel().tolist() == pytest.approx(model.get_vertices())
+    assert local_model.get_indices() == model.get_indices()
+    origin_model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder',
+                                    {'float32Vertices': True, 'localOrigin': [offset, 0.0, 0.0]})[0]
+    assert origin_model.get_origin() == [offset, 0.0, 0.0]
+    assert (origin_model.get_vertices_array() + origin_model.get_origin()).ravel().tolist() == pytest.approx(
+        model.get_vertices())
+
+
+def test_compact_geometry():
+    rpk = asset_file('candler.rpk')
+    shape_geo_from_obj = pyprt.InitialShape(asset_file('candler_footprint.obj'))
+    m = pyprt.ModelGenerator([shape_geo_from_obj])
+    model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {'emitReport': False})[0]
+    compact_model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder',
+                                     {'emitReport': False, 'compactGeometry': True})[0]
+    assert compact_model.get_vertices() == []
+    buffer = compact_model.get_compact_geometry()
+    assert len(buffer) * 3 < len(model.get_vertices()) * 8
+    vertices, indices, faces = pyprt.decode_compact_geometry(buffer)
+    expected_vertices = model.get_vertices_array()
+    extent = expected_vertices.max(axis=0) - expected_vertices.min(axis=0)
+    assert abs(vertices - expected_vertices).max() <= extent.max() / 65535.0
+    assert indices.tolist() == model.get_indices()
+    assert faces.tolist() == model.get_faces()
+    assert pyprt.decode_compact_geometry(b'invalid') is None
+    invalid_models = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder',
+                                      {'compactGeometry': True, 'quantizationBits': 8})
+    assert all(len(invalid_model.get_compact_geometry()) == 0 for invalid_model in invalid_models)
+
+
+def test_summary():
+    rpk = asset_file('extrusion_rule.rpk')
+    attrs = {'minBuildingHeight': 23.0,
+             'maxBuildingHeight': 23.0}
+    shape_geo = pyprt.InitialShape([-10.0, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0])
+    m = pyprt.ModelGenerator([shape_geo])
+    model = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {'emitGeometry': False, 'emitSummary': True})[0]
+    assert model.get_vertices() == []
+    summary = model.get_summary()
+    assert summary['footprintArea'] == pytest.approx(200.0)
+    assert summary['height'] == pytest.approx(23.0)
+    assert summary['volume'] == pytest.approx(4600.0)
+    assert summary['surfaceArea'] == pytest.approx(1780.0)
+    assert summary['boundingBoxMin'] == pytest.approx((-10.0, 0.0, 0.0))
+    assert summary['boundingBoxMax'] == pytest.approx((10.0, 23.0, 10.0))
+    assert m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {})[0].get_summary() == {}
+
+
+def test_face_shape_ids():
+    rpk = asset_file('candler.rpk')
+    shape_geo_from_obj = pyprt.InitialShape(asset_file('candler_footprint.obj'))
+    m = pyprt.ModelGenerator([shape_geo_from_obj])
+    model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {'emitReport': False})[0]
+    tagged_model = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder',
+                                    {'emitReport': False, 'emitFaceShapeIds': True})[0]
+    assert len(model.get_face_shape_ids_array()) == 0
+    face_shape_ids = tagged_model.get_face_shape_ids_array()
+    shape_names = tagged_model.get_shape_names()
+    assert len(face_shape_ids) == len(tagged_model.get_faces()) == len(model.get_faces())
+    assert len(shape_names) > 1
+    assert face_shape_ids.max() < len(shape_names)
+
+
+def test_generate_batch():
+    rpk = asset_file('extrusion_rule.rpk')
+    shape_geo = pyprt.InitialShape([-10.0, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0])
+    shape_geo_from_obj = pyprt.InitialShape(asset_file('building_parcel.obj'))
+    m = pyprt.ModelGenerator([shape_geo, shape_geo_from_obj])
+    models = m.generate_model([{}], rpk, 'com.esri.pyprt.PyEncoder', {'emitReport': False})
+    batch = m.generate_batch([{}], rpk, {})
+    assert len(batch) == 2
+    vertices = batch.get_vertices_array()
+    indices = batch.get_indices_array()
+    faces = batch.get_faces_array()
+    vertex_offsets = batch.get_vertex_offsets()
+    index_offsets = batch.get_index_offsets()
+    face_offsets = batch.get_face_offsets()
+    for i, model in enumerate(models):
+        assert vertices[vertex_offsets[i]:vertex_offsets[i + 1]].flatten().tolist() == model.get_vertices()
+        assert indices[index_offsets[i]:index_offsets[i + 1]].tolist() == model.get_indices()
+        assert faces[face_offsets[i]:face_offsets[i + 1]].tolist() == model.get_faces()
+    assert vertex_offsets[-1] == len(vertices)
+    assert len(m.generate_batch([{}], rpk, {'instancing': True})) == 0
+    assert len(m.generate_batch([{}], rpk, {'compactGeometry': True})) == 0
+
+
+def test_batch_arrow_export():
+    pa = pytest.importorskip('pyarrow')
+    rpk = asset_file('envelope2002.rpk')
+    attrs = {'report_but_not_display_green': True, 'seed': 666}
+    shape_geo_from_obj = pyprt.InitialShape(asset_file('building_parcel.obj'))
+    m = pyprt.ModelGenerator([shape_geo_from_obj])
+    model = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {})[0]
+    batch = m.generate_batch([attrs], rpk, {})
+    table = pa.record_batch(batch)
+    assert table.num_rows == 1
+    assert table.schema.field('vertices').metadata[b'ARROW:extension:name'] == b'geoarrow.multipoint'
+    vertices = table.column('vertices')[0].values.flatten().to_pylist()
+    assert vertices == model.get_vertices()
+    assert table.column('indices')[0].as_py() == model.get_indices()
+    assert table.column('faces')[0].as_py() == model.get_faces()
+    report = table.column('report')[0].as_py()
+    assert report == model.get_report()
+    assert pa.RecordBatchReader.from_stream(batch).read_all().num_rows == 1
+
+
+def test_batch_report_table():
+    rpk = asset_file('envelope2002.rpk')
+    attrs = {'report_but_not_display_green': True, 'seed': 666}
+    shape_geo_from_obj = pyprt.InitialShape(asset_file('building_parcel.obj'))
+    shape_geo = pyprt.InitialShape([-10.0, 0.0, 10.0, -10.0, 0.0, 0.0, 10.0, 0.0, 0.0, 10.0, 0.0, 10.0])
+    m = pyprt.ModelGenerator([shape_geo_from_obj, shape_geo])
+    models = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {'emitGeometry': False})
+    batch = m.generate_batch([attrs], rpk, {'emitGeometry': False}, auxiliaryOutputs=['attributes'])
+    table = batch.get_report_table()
+    assert set(table.keys()) == set(models[0].get_report().keys()) | set(models[1].get_report().keys())
+    for key, column in table.items():
+        assert len(column) == 2
+        for i, model in enumerate(models):
+            if key in model.get_report():
+                assert column[i] == model.get_report()[key]
+            else:
+                assert column.mask[i]
+    attribute_table = batch.get_attribute_table()
+    assert set(attribute_table.keys()) == set(models[0].get_attributes().keys())
+    for key, column in attribute_table.items():
+        assert column.tolist() == [model.get_attributes()[key] for model in models]
+
+
+def test_batch_aggregate_reports():
+    rpk = asset_file('envelope2002.rpk')
+    attrs = {'report_but_not_display_green': True, 'seed': 666}
+    shape_geo_from_obj = pyprt.InitialShape(asset_file('building_parcel.obj'))
+    m = pyprt.ModelGenerator([shape_geo_from_obj, shape_geo_from_obj])
+    models = m.generate_model([attrs], rpk, 'com.esri.pyprt.PyEncoder', {'emitGeometry': False})
+    batch = m.generate_batch([attrs], rpk, {'emitGeometry': False})
+    values = [model.get_report()['Floor area_sum'] for model in models]
+    aggregate = batch.aggregate_reports('Floor area_sum')
+    assert aggregate['sum'] == pytest.approx(sum(values))
+    assert aggregate['mean'] == pytest.approx(sum(values) / 2)
+    assert aggregate['min'] == min(values)
+    assert aggregate['max'] == max(values)
+    assert aggregate['count'] == 2
+    assert isinstance(aggregate['count'], int)
+    groups = batch.aggregate_reports('Floor area_sum', ['count'], groupBy='Floor area_n')
+    assert groups == {models[0].get_report()['Floor area_n']: {'count': 2}}
+    groups = batch.aggregate_reports('Floor area_sum', ['count'], groupBy='seed')
+    assert groups == {666.0: {'count': 2}}
+    assert batch.aggregate_reports('Floor area_sum', ['median']) == {}
+    assert batch.aggregate_reports('unknown report') == {}
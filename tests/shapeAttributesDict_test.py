@@ -15,6 +15,7 @@
 
 import os
 import tempfile
+import numpy as np
 import pyprt
 
 CS_FOLDER = os.path.dirname(os.path.realpath(__file__))
@@ -171,3 +172,62 @@ def test_initial_shape_obj():
 
 def test_initial_shape_obj_with_child_dirs():
     convert_asset_to_fbx("OBJ-Bonnland/Bonnland_102.obj", 2)
+
+
+def test_columnar_attributes():
+    rpk = asset_file('extrusion_rule.rpk')
+    shape_geometry_1 = pyprt.InitialShape(
+        [0, 0, 0, 0, 0, 100, 100, 0, 100, 100, 0, 0])
+    shape_geometry_2 = pyprt.InitialShape(
+        [0, 0, 0, 0, 0, -10, -10, 0, -10, -10, 0, 0, -5, 0, -5])
+    m = pyprt.ModelGenerator([shape_geometry_1, shape_geometry_2])
+    attrs = [{'minBuildingHeight': 30.0, 'maxBuildingHeight': 30.0, 'text': 'hello'},
+             {'minBuildingHeight': 15.0, 'maxBuildingHeight': 15.0, 'text': 'world'}]
+    columns = {'minBuildingHeight': np.array([30.0, 15.0]), 'maxBuildingHeight': np.array([30.0, 15.0]),
+               'text': ['hello', 'world']}
+    models = m.generate_model(attrs, rpk, 'com.esri.pyprt.PyEncoder', {})
+    columnar_models = m.generate_model(columns, rpk, 'com.esri.pyprt.PyEncoder', {})
+    assert len(columnar_models) == 2
+    for model, columnar_model in zip(models, columnar_models):
+        assert columnar_model.get_vertices() == model.get_vertices()
+        assert columnar_model.get_report() == model.get_report()
+    columns['text'] = np.array(['hello', 'world'], dtype=object)
+    chunked_models = [chunk_model for chunk in m.generate_iter(columns, rpk, 'com.esri.pyprt.PyEncoder', {},
+                                                               chunkSize=1) for chunk_model in chunk]
+    assert len(chunked_models) == 2
+    for model, chunked_model in zip(models, chunked_models):
+        assert chunked_model.get_vertices() == model.get_vertices()
+        assert chunked_model.get_report() == model.get_report()
+
+
+def test_identical_dicts():
+    rpk = asset_file('extrusion_rule.rpk')
+    shape_geometry_1 = pyprt.InitialShape(
+        [0, 0, 0, 0, 0, 100, 100, 0, 100, 100, 0, 0])
+    shape_geometry_2 = pyprt.InitialShape(
+        [0, 0, 0, 0, 0, -10, -10, 0, -10, -10, 0, 0, -5, 0, -5])
+    shape_geometry_3 = pyprt.InitialShape(
+        [0, 0, 0, 0, 0, -10, 10, 0, -10, 10, 0, 0, -5, 0, -5])
+    m = pyprt.ModelGenerator([shape_geometry_1, shape_geometry_2, shape_geometry_3])
+    attrs = [{'minBuildingHeight': 30.0, 'maxBuildingHeight': 30.0},
+             {'minBuildingHeight': 30.0, 'maxBuildingHeight': 30.0},
+             {'minBuildingHeight': 20.0, 'maxBuildingHeight': 20.0}]
+    models = m.generate_model(attrs, rpk, 'com.esri.pyprt.PyEncoder', {})
+    broadcast_models = m.generate_model([attrs[0]], rpk, 'com.esri.pyprt.PyEncoder', {})
+    assert models[0].get_vertices() == broadcast_models[0].get_vertices()
+    assert models[1].get_vertices() == broadcast_models[1].get_vertices()
+    assert models[2].get_vertices() != broadcast_models[2].get_vertices()
+
+
+def test_declared_attribute_types():
+    rpk = asset_file('extrusion_rule.rpk')
+    shape_geometry = pyprt.InitialShape(
+        [0, 0, 0, 0, 0, 100, 100, 0, 100, 100, 0, 0])
+    m = pyprt.ModelGenerator([shape_geometry])
+    float_models = m.generate_model([{'minBuildingHeight': 30.0, 'maxBuildingHeight': 30.0}], rpk,
+                                    'com.esri.pyprt.PyEncoder', {})
+    int_models = m.generate_model([{'minBuildingHeight': 30, 'maxBuildingHeight': 30}], rpk,
+                                  'com.esri.pyprt.PyEncoder', {})
+    assert int_models[0].get_vertices() == float_models[0].get_vertices()
+    wrong_models = m.generate_model([{'minBuildingHeight': 'high'}], rpk, 'com.esri.pyprt.PyEncoder', {})
+    assert len(wrong_models) == 0